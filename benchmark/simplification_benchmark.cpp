@@ -0,0 +1,271 @@
+// Times the stages of loading and simplifying a generated map: construction, orientation, sorting and spatial
+// reordering of the graph, VW and KSBB runs to a fixed complexity, serially and in parallel rounds, and recalling
+// random complexities from history.
+//
+// usage: simplification_benchmark [cells] [chain] [islands] [threads]
+//   cells    number of cells per side of the map (default 24)
+//   chain    number of interior vertices on each cell border (default 40)
+//   islands  number of islands per side of each cell (default 1)
+//   threads  number of threads for the stages that use them (default: hardware concurrency)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "library/edge_collapse.h"
+#include "library/straight_graph.h"
+#include "library/vertex_removal.h"
+#include "test/generated_map.h"
+
+using namespace cartocrow;
+using namespace cartocrow::simplification;
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	template <typename F> double millis(F&& f) {
+		auto start = Clock::now();
+		f();
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	void report(const std::string& stage, double ms, const std::string& note = "") {
+		std::cout << std::left << std::setw(36) << stage << std::right << std::setw(12) << std::fixed
+		          << std::setprecision(1) << ms << " ms";
+		if (!note.empty()) {
+			std::cout << "   " << note;
+		}
+		std::cout << "\n";
+	}
+
+	// peak resident set size of the process in MB, or -1 if unknown
+	double peakMemory() {
+#if defined(__unix__)
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss / 1024.0;
+#elif defined(__APPLE__)
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+		return -1;
+#endif
+	}
+
+	template <class Graph> Rectangle<typename Graph::Kernel> boxOf(Graph& graph) {
+		return utils::boxOf<typename Graph::Vertex, typename Graph::Kernel>(graph.getVertices());
+	}
+
+	// the points and edges of the graph, with the points in random order
+	template <class Graph>
+	void shuffledArrays(Graph& graph, std::vector<Point<typename Graph::Kernel>>& points,
+	                    std::vector<std::pair<int, int>>& pairs) {
+		std::vector<int> position(graph.getVertexCount());
+		std::iota(position.begin(), position.end(), 0);
+		std::shuffle(position.begin(), position.end(), std::mt19937(7));
+
+		points.assign(graph.getVertexCount(), Point<typename Graph::Kernel>());
+		for (auto* v : graph.getVertices()) {
+			points[position[v->graphIndex()]] = v->getPoint();
+		}
+		pairs.clear();
+		for (auto* e : graph.getEdges()) {
+			pairs.emplace_back(position[e->getSource()->graphIndex()], position[e->getTarget()->graphIndex()]);
+		}
+	}
+
+	template <typename K> struct Stages {
+		using InputGraph = StraightGraph<std::monostate, std::monostate, K>;
+		using VWGraph = HistoricVertexRemovalGraph<K>;
+		using KSBBGraph = HistoricEdgeCollapseGraph<K>;
+
+		InputGraph* input;
+		int target;
+		int threads;
+		int depth = 8;
+		// cost slack of the runs in parallel rounds
+		double slack = 0.5;
+
+		// VW to the target complexity; returns the history for the recall stage
+		typename VWGraph::BaseGraph* runVW(const std::string& name, int init_threads, int checkpoints,
+		                                   VWGraph*& history, bool rounds = false) {
+			auto* base = copy<InputGraph, typename VWGraph::BaseGraph>(input);
+			history = new VWGraph(*base);
+			history->setCheckpointInterval(checkpoints);
+			VertexQuadTree<VWGraph> pqt(boxOf(*base), depth);
+			VisvalingamWhyatt<VWGraph> alg(*history, pqt);
+			alg.setThreadCount(init_threads);
+			alg.setParallelRounds(rounds);
+			alg.setCostSlack(slack);
+
+			report(name + " initialize", millis([&] { alg.initialize(true); }),
+			       std::to_string(init_threads) + " thread(s)");
+			double ms = millis([&] { alg.run([this](int c, Number<K>) { return c <= target; }); });
+			report(name + " run", ms,
+			       std::to_string(history->getEdgeCount()) + " edges in " + std::to_string(history->getBatchCount())
+			           + " steps, " + std::to_string(alg.getPredicateStats().filtered) + " filtered / "
+			           + std::to_string(alg.getPredicateStats().exact) + " exact blocking tests");
+			return base;
+		}
+
+		void runKSBB(const std::string& name, int init_threads, bool rounds = false) {
+			auto* base = copy<InputGraph, typename KSBBGraph::BaseGraph>(input);
+			KSBBGraph history(*base);
+			Rectangle<K> box = boxOf(*base);
+			VertexQuadTree<KSBBGraph> pqt(box, depth);
+			EdgeQuadTree<KSBBGraph> sqt(box, depth, 0.05);
+			KronenfeldEtAl<KSBBGraph> alg(history, sqt, pqt);
+			alg.setThreadCount(init_threads);
+			alg.setParallelRounds(rounds);
+			alg.setCostSlack(slack);
+
+			report(name + " initialize", millis([&] { alg.initialize(true, true); }),
+			       std::to_string(init_threads) + " thread(s)");
+			double ms = millis([&] { alg.run([this](int c, Number<K>) { return c <= target; }); });
+			report(name + " run", ms,
+			       std::to_string(history.getEdgeCount()) + " edges in " + std::to_string(history.getBatchCount()) + " steps");
+			delete base;
+		}
+
+		// random jumps across the whole range of complexities, and jumps between its two ends as with a slider
+		void recall(const std::string& name, VWGraph& history) {
+			std::mt19937 rng(3);
+			int low = history.getEdgeCount();
+			int high = history.getInputComplexity();
+			int margin = (high - low) / 20 + 1;
+			const int jumps = 200;
+			double uniform = millis([&] {
+				for (int i = 0; i < jumps; i++) {
+					history.recallComplexity(low + rng() % (high - low + 1));
+				}
+			});
+			double ends = millis([&] {
+				for (int i = 0; i < jumps; i++) {
+					history.recallComplexity(i % 2 == 0 ? high - rng() % margin : low + rng() % margin);
+				}
+			});
+			std::string checkpoints = std::to_string(history.getCheckpointCount()) + " checkpoints";
+			report(name + ", random", uniform / jumps, "mean of " + std::to_string(jumps) + " jumps, " + checkpoints);
+			report(name + ", end to end", ends / jumps, "mean of " + std::to_string(jumps) + " jumps, " + checkpoints);
+		}
+	};
+
+}
+
+int main(int argc, char* argv[]) {
+	int cells = argc > 1 ? std::atoi(argv[1]) : 24;
+	int chain = argc > 2 ? std::atoi(argv[2]) : 40;
+	int islands = argc > 3 ? std::atoi(argv[3]) : 1;
+	int threads = argc > 4 ? std::atoi(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+	using InputGraph = StraightGraph<std::monostate, std::monostate, Exact>;
+
+	InputGraph* generated = test::generateMap<InputGraph>(cells, chain, 1, islands);
+	std::vector<Point<Exact>> points;
+	std::vector<std::pair<int, int>> pairs;
+	shuffledArrays(*generated, points, pairs);
+	delete generated;
+
+	std::cout << points.size() << " vertices, " << pairs.size() << " edges, " << threads << " thread(s)\n\n";
+
+	// construction: one element at a time, skipping repeated edges as the loaders did, and in bulk
+	InputGraph* single = new InputGraph();
+	single->setThreadCount(threads);
+	double add_ms = millis([&] {
+		std::vector<InputGraph::Vertex*> vertices;
+		for (const Point<Exact>& pt : points) {
+			vertices.push_back(single->addVertex(pt));
+		}
+		for (auto [s, t] : pairs) {
+			if (s != t && !vertices[s]->isNeighborOf(vertices[t])) {
+				single->addEdge(vertices[s], vertices[t]);
+			}
+		}
+	});
+	double orient_ms = millis([&] { single->orient(); });
+	double sort_ms = millis([&] { single->sortIncidentEdges(); });
+	report("addVertex/addEdge", add_ms);
+	report("orient", orient_ms);
+	report("sortIncidentEdges", sort_ms);
+	report("destroy", millis([&] { delete single; }));
+
+	InputGraph* input = new InputGraph();
+	input->setThreadCount(threads);
+	double build_ms = millis([&] { input->build(points, pairs); });
+	report("build (orients and sorts)", build_ms,
+	       std::to_string((long long) (points.size() / (build_ms / 1000))) + " vertices/s, versus "
+	           + std::to_string((long long) (points.size() / ((add_ms + orient_ms + sort_ms) / 1000)))
+	           + " one at a time");
+
+	int target = input->getEdgeCount() / 10;
+	std::cout << "\nsimplifying to " << target << " edges, vertices in shuffled order\n";
+	Stages<Exact> exact{ input, target, threads };
+	{
+		HistoricVertexRemovalGraph<Exact>* history;
+		auto* base = exact.runVW("VW", 1, 0, history);
+		exact.recall("VW recall", *history);
+		delete history;
+		delete base;
+	}
+	exact.runKSBB("KSBB", 1);
+
+	report("reorderSpatially", millis([&] { input->reorderSpatially(true); }));
+	std::cout << "\nsimplifying to " << target << " edges, vertices in spatial order\n";
+	for (int checkpoints : { 0, input->getEdgeCount() / 16 + 1 }) {
+		HistoricVertexRemovalGraph<Exact>* history;
+		auto* base = exact.runVW("VW", threads, checkpoints, history);
+		exact.recall("VW recall", *history);
+		delete history;
+		delete base;
+	}
+	exact.runKSBB("KSBB", threads);
+
+	std::cout << "\nsimplifying to " << target << " edges in parallel rounds, cost slack " << exact.slack << "\n";
+	{
+		HistoricVertexRemovalGraph<Exact>* history;
+		auto* base = exact.runVW("VW rounds", threads, 0, history, true);
+		delete history;
+		delete base;
+	}
+	exact.runKSBB("KSBB rounds", threads, true);
+
+	std::cout << "\ninexact kernel, vertices in spatial order\n";
+	{
+		using InexactGraph = StraightGraph<std::monostate, std::monostate, Inexact>;
+		InexactGraph* inexact = test::generateMap<InexactGraph>(cells, chain, 1, islands);
+		inexact->setThreadCount(threads);
+		inexact->orient();
+		inexact->sortIncidentEdges();
+		inexact->reorderSpatially(true);
+		Stages<Inexact> stages{ inexact, target, threads };
+		HistoricVertexRemovalGraph<Inexact>* history;
+		auto* base = stages.runVW("VW", threads, 0, history);
+		delete history;
+		delete base;
+		base = stages.runVW("VW rounds", threads, 0, history, true);
+		delete history;
+		delete base;
+		stages.runKSBB("KSBB", threads);
+		stages.runKSBB("KSBB rounds", threads, true);
+		delete inexact;
+	}
+
+	std::cout << "\nreserved for the input graph: " << input->getReservedBytes() / (1024 * 1024) << " MB\n";
+	std::cout << "peak memory: " << peakMemory() << " MB\n";
+	delete input;
+	return 0;
+}
@@ -2,6 +2,7 @@
 
 #include <QCheckBox>
 #include <QDockWidget>
+#include <QDoubleSpinBox>
 #include <QFileDialog>
 #include <QProgressDialog>
 #include <QPushButton>
@@ -18,6 +19,7 @@
 #include "ipe_reader.h"
 #include "read_graph_gdal.h"
 #include "restrictor.h"
+#include "topology_snapshot.h"
 
 void launchGUI(int argc, char* argv[]) {
 	QApplication app(argc, argv);
@@ -66,7 +68,7 @@ void SimplificationGUI::addIOTab() {
 	auto* loadFileButton = new QPushButton("Load file");
 	layout->addWidget(loadFileButton);
 
-	auto* txt = new QLabel("<p>Currently supported file formats:</p><ul><li>Shapefiles (*.shp) containing (multi)polygons with holes.</li><li>Geojson files (*.geojson) containing (multi)polygons with holes.</li><li>IPE files (*.ipe) containing polygons, polylines and points. Note that these cannot be saved to a Shapefile currently.</li></ul>");
+	auto* txt = new QLabel("<p>Currently supported file formats:</p><ul><li>Shapefiles (*.shp) containing (multi)polygons with holes.</li><li>Geojson files (*.geojson) containing (multi)polygons with holes.</li><li>IPE files (*.ipe) containing polygons, polylines and points. Note that these cannot be saved to a Shapefile currently.</li><li>Topology snapshots (*.ccsg) of a previously loaded map.</li></ul>");
 	txt->setWordWrap(true);
 	layout->addWidget(txt);
 
@@ -74,8 +76,11 @@ void SimplificationGUI::addIOTab() {
 	auto* outToInButton = new QPushButton("Set current result to input");
 	layout->addWidget(outToInButton);
 
+	auto* saveSnapshotButton = new QPushButton("Save topology snapshot");
+	layout->addWidget(saveSnapshotButton);
+
 	connect(loadFileButton, &QPushButton::clicked, [this]() {
-		std::filesystem::path filePath = QFileDialog::getOpenFileName(this, tr("Select map"), curr_dir, tr("Accepted formats (*.shp *.geojson *.ipe);;Shapefiles (*.shp);;Geojson (*.geojson);;IPE files(*.ipe)")).toStdString();
+		std::filesystem::path filePath = QFileDialog::getOpenFileName(this, tr("Select map"), curr_dir, tr("Accepted formats (*.shp *.geojson *.ipe *.ccsg);;Shapefiles (*.shp);;Geojson (*.geojson);;IPE files(*.ipe);;Topology snapshots (*.ccsg)")).toStdString();
 		if (filePath == "") return;
 		curr_dir = QString::fromStdU16String(filePath.parent_path().u16string());
 		m_settings.setString("dir", curr_dir.toStdString());
@@ -92,6 +97,20 @@ void SimplificationGUI::addIOTab() {
 
 
 
+	connect(saveSnapshotButton, &QPushButton::clicked, [this]() {
+		if (input == nullptr) {
+			std::cout << "Cannot save snapshot, no input was loaded." << std::endl;
+			return;
+		}
+
+		std::filesystem::path filePath = QFileDialog::getSaveFileName(this, tr("Select snapshot file"), curr_dir, tr("Topology snapshots (*.ccsg)")).toStdString();
+		if (filePath == "") return;
+		curr_dir = QString::fromStdU16String(filePath.parent_path().u16string());
+		m_settings.setString("dir", curr_dir.toStdString());
+
+		saveTopologySnapshot(filePath, input, m_regions, m_spatialRef);
+		});
+
 	connect(outToInButton, &QPushButton::clicked, [this]() {
 
 		SimplificationAlgorithm* alg = algorithms[algorithmSelector->currentIndex()];
@@ -290,6 +309,19 @@ void SimplificationGUI::addSimplifyTab() {
 	desiredComplexity->setValue(10);
 	layout->addWidget(desiredComplexity);
 
+	auto* thresholdButton = new QPushButton("Run to threshold");
+	layout->addWidget(thresholdButton);
+	auto* desiredThreshold = new QDoubleSpinBox();
+	desiredThreshold->setDecimals(6);
+	desiredThreshold->setMaximum(1e12);
+	desiredThreshold->setValue(0);
+	layout->addWidget(desiredThreshold);
+
+	auto* saveHistoryButton = new QPushButton("Save history");
+	layout->addWidget(saveHistoryButton);
+	auto* loadHistoryButton = new QPushButton("Load history");
+	layout->addWidget(loadHistoryButton);
+
 	complexitySlider = new QSlider();
 	complexitySlider->setFocusPolicy(Qt::StrongFocus);
 	complexitySlider->setTickPosition(QSlider::TicksBothSides);
@@ -379,6 +411,80 @@ void SimplificationGUI::addSimplifyTab() {
 		}
 		});
 
+	connect(thresholdButton, &QPushButton::clicked, [this, desiredThreshold]() {
+		SimplificationAlgorithm* alg = algorithms[algorithmSelector->currentIndex()];
+		if (alg->hasResult()) {
+
+			int start = alg->getComplexity();
+
+			QProgressDialog progress("Simplifying", "Stop", 0, start, this);
+			progress.setWindowModality(Qt::WindowModal);
+			progress.setMinimumDuration(1000);
+			progress.setValue(0);
+
+			alg->runToThreshold(desiredThreshold->value(),
+				[&progress, &start](int c) {
+					std::string lbl = "Complexity " + std::to_string(c);
+					progress.setLabelText(QString::fromStdString(lbl));
+					progress.setValue(start - std::min(c, start));
+				},
+				[&progress]() {
+					return progress.wasCanceled();
+				});
+
+			progress.setValue(start);
+
+			desiredComplexity->setValue(alg->getComplexity());
+			complexitySlider->setValue(alg->getComplexity());
+			m_renderer->repaint();
+		}
+		});
+
+	connect(saveHistoryButton, &QPushButton::clicked, [this]() {
+		SimplificationAlgorithm* alg = algorithms[algorithmSelector->currentIndex()];
+		if (!alg->hasResult()) {
+			std::cout << "Cannot save history, the algorithm was not initialized." << std::endl;
+			return;
+		}
+
+		std::filesystem::path filePath = QFileDialog::getSaveFileName(this, tr("Select history file"), curr_dir, tr("Simplification histories (*.cchist)")).toStdString();
+		if (filePath == "") return;
+		curr_dir = QString::fromStdU16String(filePath.parent_path().u16string());
+		m_settings.setString("dir", curr_dir.toStdString());
+
+		if (!alg->saveHistory(filePath)) {
+			std::cout << "Failed to save history." << std::endl;
+		}
+		});
+
+	connect(loadHistoryButton, &QPushButton::clicked, [this]() {
+		SimplificationAlgorithm* alg = algorithms[algorithmSelector->currentIndex()];
+		if (!alg->hasResult()) {
+			std::cout << "Cannot load history, the algorithm was not initialized." << std::endl;
+			return;
+		}
+
+		std::filesystem::path filePath = QFileDialog::getOpenFileName(this, tr("Select history file"), curr_dir, tr("Simplification histories (*.cchist)")).toStdString();
+		if (filePath == "") return;
+		curr_dir = QString::fromStdU16String(filePath.parent_path().u16string());
+		m_settings.setString("dir", curr_dir.toStdString());
+
+		QProgressDialog progress("Loading history", nullptr, 0, 2, this);
+		progress.setWindowModality(Qt::WindowModal);
+		progress.setMinimumDuration(1000);
+		progress.setValue(1);
+
+		if (!alg->loadHistory(filePath)) {
+			std::cout << "Failed to load history, the file is not a valid history of this input." << std::endl;
+		}
+
+		progress.setValue(2);
+
+		desiredComplexity->setValue(alg->getComplexity());
+		complexitySlider->setValue(alg->getComplexity());
+		updatePaintings();
+		});
+
 	connect(stepSpin, &QSpinBox::textChanged, [this, stepSpin]() {
 		complexitySlider->setSingleStep(stepSpin->value());
 		});
@@ -593,8 +699,11 @@ void SimplificationGUI::loadInput(InputGraph* graph, const bool keepregions) {
 	updatePaintings();
 
 	if (input != nullptr) {
+		input->setThreadCount(std::thread::hardware_concurrency());
 		input->orient();
 		input->sortIncidentEdges();
+		// nothing refers to the elements of the new input yet, so they can be moved in memory
+		input->reorderSpatially(true);
 		desiredComplexity->setMaximum(input->getEdgeCount());
 		complexitySlider->setMaximum(input->getEdgeCount());
 		m_renderer->fitInView(utils::boxOf<InputGraph::Vertex, Exact>(input->getVertices()).bbox());
@@ -635,6 +744,22 @@ void SimplificationGUI::loadInput(const std::filesystem::path& path, const int d
 		}
 		graph = constructGraphAndRegisterBoundaries(*m_regions, depth);
 	}
+	else if (path.extension() == ".ccsg") {
+		auto [g, rs, sr] = loadTopologySnapshot(path);
+		graph = g;
+		m_regions = rs;
+		m_spatialRef = sr;
+		curr_file->setText(QString::fromStdString(path.filename().string()));
+		if (!sr.has_value()) {
+			curr_srs->setText(QString::fromStdString("<i>No spatial reference</i>"));
+		}
+		else if (sr.value().size() > 40) {
+			curr_srs->setText(QString::fromStdString(sr.value().substr(0, 37) + "..."));
+		}
+		else {
+			curr_srs->setText(QString::fromStdString(sr.value()));
+		}
+	}
 	else {
 		std::cout << "Unexpected file extension: " << path.extension() << std::endl;
 		curr_file->setText(QString::fromStdString("<i>No file</i>"));
@@ -3,12 +3,11 @@
 #include <ipepath.h>
 #include <cartocrow/reader/ipe_reader.h>
 
-#include "library/vertex_quad_tree.h"
 #include "library/utils.h"
+#include "unique_points.h"
 
 template<class Graph>
 Graph* readIpeFile(const std::filesystem::path& file, const int depth) {
-	using Vertex = Graph::Vertex;
 	using Kernel = Graph::Kernel;
 	std::shared_ptr<ipe::Document> document = IpeReader::loadIpeFile(file);
 
@@ -53,8 +52,11 @@ Graph* readIpeFile(const std::filesystem::path& file, const int depth) {
 
 	Rectangle<Kernel> box = utils::boxOf<Kernel>(points);
 
-	// construct the graph
-	VertexQuadTree<Graph> pqt(box, depth);
+	// number the distinct points and collect the edges between them, to construct the graph in one go
+	UniquePoints<Kernel> unique(box, depth, 0.00001);
+	unique.reserve(points.size());
+	std::vector<std::pair<int, int>> edges;
+	edges.reserve(points.size());
 
 	for (int i = 0; i < page->count(); i++) {
 		auto object = page->object(i);
@@ -67,39 +69,29 @@ Graph* readIpeFile(const std::filesystem::path& file, const int depth) {
 			if (subpath->type() != ipe::SubPath::Type::ECurve) continue;
 			auto curve = subpath->asCurve();
 
-			Vertex* prev = nullptr;
+			int prev = -1;
 			for (int k = 0; k < curve->countSegmentsClosing(); k++) {
 				auto segment = curve->segment(k);
 				auto pt = matrix * segment.cp(0);
 
-				Point<Kernel> point(pt.x, pt.y);
-
-				Vertex* next = pqt.findElement(point, 0.00001);
-				if (next == nullptr) {
-					next = graph->addVertex(point);
-					pqt.insert(*next);
-				}
-				if (prev != nullptr && !next->isNeighborOf(prev) && next != prev) {
-					graph->addEdge(prev, next);
+				int next = unique.indexOf(Point<Kernel>(pt.x, pt.y));
+				if (prev >= 0) {
+					edges.emplace_back(prev, next);
 				}
 				prev = next;
 			}
 
 			auto pt = matrix * curve->segment(curve->countSegmentsClosing() - 1).last();
 
-			Point<Kernel> point(pt.x, pt.y);
-
-			Vertex* next = pqt.findElement(point, 0.00001);
-			if (next == nullptr) {
-				next = graph->addVertex(point);
-				pqt.insert(*next);
-			}
-			if (prev != nullptr && !next->isNeighborOf(prev) && next != prev) {
-				graph->addEdge(prev, next);
+			int next = unique.indexOf(Point<Kernel>(pt.x, pt.y));
+			if (prev >= 0) {
+				edges.emplace_back(prev, next);
 			}
 			prev = next;
 		}
 	}
 
+	graph->build(unique.getPoints(), edges);
+
 	return graph;
 }
\ No newline at end of file
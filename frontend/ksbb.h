@@ -14,6 +14,10 @@ public:
 	void initialize(InputGraph* graph, const int depth) override;
 	void runToComplexity(const int k, std::optional<std::function<void(int)>> progress = std::nullopt,
 		std::optional<std::function<bool()>> cancelled = std::nullopt)  override;
+	void runToThreshold(const Number<Inexact> t, std::optional<std::function<void(int)>> progress = std::nullopt,
+		std::optional<std::function<bool()>> cancelled = std::nullopt)  override;
+	bool saveHistory(const std::filesystem::path& path) override;
+	bool loadHistory(const std::filesystem::path& path) override;
 	int getComplexity() override;
 	int getMaximumComplexity() override;
 	std::shared_ptr<GeometryPainting> getPainting(const VertexMode vmode) override;
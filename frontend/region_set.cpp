@@ -1,5 +1,7 @@
 #include "region_set.h"
 
+#include "unique_points.h"
+
 namespace cartocrow {
 
 	bool ArcRegistration::validate(InputGraph* graph) {
@@ -47,53 +49,42 @@ namespace cartocrow {
 
 		Rectangle<Exact> box = utils::boxOf<Exact>(points);
 
-		// construct the graph
-		VertexQuadTree<InputGraph> pqt(box, depth);
+		// number the distinct points and collect the edges between them, to construct the graph in one go
+		UniquePoints<Exact> unique(box, depth, 0.00001);
+		unique.reserve(points.size());
+		std::vector<std::pair<int, int>> edges;
+		edges.reserve(points.size());
 
-		auto findVtx = [&pqt, &graph](Point<Exact> pt) {
-			InputGraph::Vertex* v = pqt.findElement(pt, 0.00001);
-			if (v == nullptr) {
-				v = graph->addVertex(pt);
-				pqt.insert(*v);
-			}
-			return v;
-			};
+		// the point index of each ring vertex, to register the boundaries afterwards
+		std::vector<std::vector<int>> ring_indices;
 
 		for (Region<Exact>& r : rs) {
 			for (Polygon<Exact> poly : r.rings) {
-				InputGraph::Vertex* prev = nullptr;
-				InputGraph::Vertex* first = nullptr;
+				std::vector<int>& indices = ring_indices.emplace_back();
 				for (Point<Exact> p : poly.vertices()) {
-					InputGraph::Vertex* curr = findVtx(p);
-
-					if (prev == nullptr) {
-						first = curr;
-					}
-					else if (prev != curr && !prev->isNeighborOf(curr)) {
-						graph->addEdge(prev, curr);
-					}
-
-					prev = curr;
+					indices.push_back(unique.indexOf(p));
 				}
-				if (prev != first && !prev->isNeighborOf(first)) {
-					graph->addEdge(prev, first);
+				for (int i = 1; i < indices.size(); i++) {
+					edges.emplace_back(indices[i - 1], indices[i]);
 				}
+				edges.emplace_back(indices.back(), indices.front());
 			}
 		}
 
-		// register boundaries
-		graph->orient();
+		// the graph is oriented by building it, which registering the boundaries requires
+		graph->build(unique.getPoints(), edges);
 
+		int ring = 0;
 		for (Region<Exact>& r : rs) {
 
-			for (Polygon<Exact> poly : r.rings) {
+			for (int k = 0; k < r.rings.size(); k++) {
 
 				ArcRegistration reg;
 
 				InputGraph::Vertex* prev = nullptr;
 				InputGraph::Vertex* first = nullptr;
-				for (Point<Exact> p : poly.vertices()) {
-					InputGraph::Vertex* curr = findVtx(p);
+				for (int index : ring_indices[ring++]) {
+					InputGraph::Vertex* curr = graph->getVertices()[index];
 
 					if (prev == nullptr) {
 						first = curr;
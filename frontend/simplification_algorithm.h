@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cartocrow/renderer/geometry_painting.h>
+#include <filesystem>
 #include "library/straight_graph.h"
 #include "graph_painter.h"
 
@@ -17,6 +18,12 @@ public:
 	virtual void initialize(InputGraph* graph, const int depth) = 0;
 	virtual void runToComplexity(const int k, std::optional<std::function<void(int)>> progress = std::nullopt,
 		std::optional<std::function<bool()>> cancelled = std::nullopt) = 0;
+	virtual void runToThreshold(const Number<Inexact> t, std::optional<std::function<void(int)>> progress = std::nullopt,
+		std::optional<std::function<bool()>> cancelled = std::nullopt) = 0;
+	// writes the result and its full history, such that loadHistory can restore it without rerunning the algorithm
+	virtual bool saveHistory(const std::filesystem::path& path) = 0;
+	// replaces the result and its history by those stored by saveHistory; the algorithm must be initialized
+	virtual bool loadHistory(const std::filesystem::path& path) = 0;
 	virtual int getComplexity() = 0;
 	virtual int getMaximumComplexity() = 0;
 	virtual std::shared_ptr<GeometryPainting> getPainting(const VertexMode vmode) = 0;
@@ -0,0 +1,229 @@
+#include "topology_snapshot.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "library/binary_io.h"
+#include "library/graph_snapshot.h"
+
+namespace {
+
+	constexpr char REGIONS_MAGIC[8] = { 'C', 'C', 'S', 'R', 'E', 'G', 'N', 'S' };
+
+	void writeAttribute(std::ostream& os, const RegionAttribute& value) {
+		binary_io::write<std::uint32_t>(os, value.index());
+		std::visit([&os](auto&& v) {
+			using T = std::decay_t<decltype(v)>;
+			if constexpr (std::is_same_v<T, std::string>) {
+				binary_io::writeString(os, v);
+			}
+			else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+				binary_io::write<std::uint64_t>(os, v.size());
+				for (const std::string& str : v) {
+					binary_io::writeString(os, str);
+				}
+			}
+			else if constexpr (std::is_same_v<T, std::vector<int>> || std::is_same_v<T, std::vector<double>>) {
+				binary_io::writeVector(os, v);
+			}
+			else {
+				binary_io::write(os, v);
+			}
+			}, value);
+	}
+
+	bool readAttribute(std::istream& is, RegionAttribute& value) {
+		std::uint32_t index;
+		if (!binary_io::read(is, index)) {
+			return false;
+		}
+
+		switch (index) {
+		case 0: {
+			int v;
+			if (!binary_io::read(is, v)) return false;
+			value = v;
+			return true;
+		}
+		case 1: {
+			std::vector<int> v;
+			if (!binary_io::readVector(is, v)) return false;
+			value = std::move(v);
+			return true;
+		}
+		case 2: {
+			double v;
+			if (!binary_io::read(is, v)) return false;
+			value = v;
+			return true;
+		}
+		case 3: {
+			std::vector<double> v;
+			if (!binary_io::readVector(is, v)) return false;
+			value = std::move(v);
+			return true;
+		}
+		case 4: {
+			std::string v;
+			if (!binary_io::readString(is, v)) return false;
+			value = std::move(v);
+			return true;
+		}
+		case 5: {
+			std::uint64_t count;
+			if (!binary_io::read(is, count) || count > (1 << 30)) return false;
+			std::vector<std::string> v(count);
+			for (std::string& str : v) {
+				if (!binary_io::readString(is, str)) return false;
+			}
+			value = std::move(v);
+			return true;
+		}
+		case 6: {
+			int64_t v;
+			if (!binary_io::read(is, v)) return false;
+			value = v;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	void writeRegions(std::ostream& os, RegionSet<Exact>* regions, std::optional<std::string> spatialReference) {
+		binary_io::writeArray(os, REGIONS_MAGIC, 8);
+
+		binary_io::write<std::uint8_t>(os, spatialReference.has_value());
+		if (spatialReference.has_value()) {
+			binary_io::writeString(os, *spatialReference);
+		}
+
+		binary_io::write<std::uint8_t>(os, regions != nullptr);
+		if (regions == nullptr) {
+			return;
+		}
+
+		binary_io::write<std::uint64_t>(os, regions->size());
+		for (const Region<Exact>& r : *regions) {
+			binary_io::writeVector(os, r.ringcounts);
+
+			binary_io::write<std::uint64_t>(os, r.arcs.size());
+			for (const ArcRegistration& reg : r.arcs) {
+				std::vector<std::int32_t> arcs;
+				for (const Arc& a : reg) {
+					arcs.push_back(a.boundary);
+					arcs.push_back(a.reverse);
+				}
+				binary_io::writeVector(os, arcs);
+			}
+
+			binary_io::write<std::uint64_t>(os, r.attributes.size());
+			for (const auto& [name, value] : r.attributes) {
+				binary_io::writeString(os, name);
+				writeAttribute(os, value);
+			}
+		}
+	}
+
+	bool readRegions(std::istream& is, int boundary_count, RegionSet<Exact>*& regions, std::optional<std::string>& spatialReference) {
+		char magic[8];
+		std::uint8_t flag;
+		if (!binary_io::readArray(is, magic, 8) || std::memcmp(magic, REGIONS_MAGIC, 8) != 0 || !binary_io::read(is, flag)) {
+			return false;
+		}
+
+		if (flag) {
+			std::string sr;
+			if (!binary_io::readString(is, sr)) return false;
+			spatialReference = sr;
+		}
+
+		if (!binary_io::read(is, flag)) {
+			return false;
+		}
+		if (!flag) {
+			regions = nullptr;
+			return true;
+		}
+
+		std::uint64_t count;
+		if (!binary_io::read(is, count) || count > (1 << 30)) {
+			return false;
+		}
+
+		auto rs = std::make_unique<RegionSet<Exact>>(count);
+		for (Region<Exact>& r : *rs) {
+			std::uint64_t arc_count, attribute_count;
+			if (!binary_io::readVector(is, r.ringcounts) || !binary_io::read(is, arc_count) || arc_count > (1 << 30)) {
+				return false;
+			}
+
+			for (int i = 0; i < arc_count; i++) {
+				std::vector<std::int32_t> arcs;
+				if (!binary_io::readVector(is, arcs) || arcs.size() % 2 != 0) {
+					return false;
+				}
+
+				ArcRegistration reg;
+				for (int j = 0; j < arcs.size(); j += 2) {
+					if (arcs[j] < 0 || arcs[j] >= boundary_count) {
+						return false;
+					}
+					reg.push_back(Arc(arcs[j], arcs[j + 1] != 0));
+				}
+				r.arcs.push_back(reg);
+			}
+
+			if (!binary_io::read(is, attribute_count) || attribute_count > (1 << 30)) {
+				return false;
+			}
+			for (int i = 0; i < attribute_count; i++) {
+				std::string name;
+				RegionAttribute value;
+				if (!binary_io::readString(is, name) || !readAttribute(is, value)) {
+					return false;
+				}
+				r.attributes[name] = value;
+			}
+		}
+
+		regions = rs.release();
+		return true;
+	}
+}
+
+bool saveTopologySnapshot(const std::filesystem::path& path, InputGraph* graph, RegionSet<Exact>* regions, std::optional<std::string> spatialReference) {
+	std::ofstream os(path, std::ios::binary);
+	if (!os) {
+		std::cout << "Could not open " << path << " for writing." << std::endl;
+		return false;
+	}
+
+	graph->orient();
+	writeSnapshot(os, graph->exportLayout());
+	writeRegions(os, regions, spatialReference);
+
+	return (bool)os;
+}
+
+std::tuple<InputGraph*, RegionSet<Exact>*, std::optional<std::string>> loadTopologySnapshot(const std::filesystem::path& path) {
+	std::ifstream is(path, std::ios::binary);
+
+	GraphLayout<Exact> layout;
+	if (!is || !readSnapshot(is, layout)) {
+		std::cout << "Not a valid topology snapshot: " << path << std::endl;
+		return { nullptr, nullptr, std::nullopt };
+	}
+
+	RegionSet<Exact>* regions;
+	std::optional<std::string> spatialReference;
+	if (!readRegions(is, layout.boundaries.size(), regions, spatialReference)) {
+		std::cout << "Invalid region data in topology snapshot: " << path << std::endl;
+		return { nullptr, nullptr, std::nullopt };
+	}
+
+	InputGraph* graph = new InputGraph();
+	graph->importLayout(layout);
+
+	return { graph, regions, spatialReference };
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <filesystem>
+#include "region_set.h"
+#include "simplification_algorithm.h"
+
+/// <summary>
+/// Stores the (oriented) input graph together with the regions and their arc registrations, such that a map can be
+/// reloaded without reading it through GDAL and reconstructing its topology. The polygon rings of the regions are not stored.
+/// </summary>
+bool saveTopologySnapshot(const std::filesystem::path& path, InputGraph* graph, RegionSet<Exact>* regions, std::optional<std::string> spatialReference);
+
+/// <summary>
+/// Reads a snapshot written by saveTopologySnapshot. The region set is nullptr if the snapshot has no regions.
+/// Returns a nullptr graph if the file is not a valid snapshot.
+/// </summary>
+std::tuple<InputGraph*, RegionSet<Exact>*, std::optional<std::string>> loadTopologySnapshot(const std::filesystem::path& path);
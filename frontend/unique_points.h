@@ -0,0 +1,56 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <cartocrow/core/core.h>
+#include <cartocrow/datastructures/point_quad_tree.h>
+
+/// <summary>
+/// Numbers the distinct points of an input, to construct a graph from them in one go. A point that lies within the
+/// tolerance of an earlier point obtains the index of that point.
+/// </summary>
+template <typename K> class UniquePoints {
+private:
+	struct Entry {
+		cartocrow::Point<K> point;
+		int index;
+	};
+
+	struct EntryTraits {
+		using Element = Entry;
+		using Kernel = K;
+
+		static cartocrow::Point<K>& get_point(Entry& entry) {
+			return entry.point;
+		}
+	};
+
+	// the quad tree refers to the entries, which a deque does not move
+	std::deque<Entry> entries;
+	cartocrow::datastructures::PointQuadTree<EntryTraits> pqt;
+	std::vector<cartocrow::Point<K>> points;
+	double tolerance;
+
+public:
+	UniquePoints(cartocrow::Rectangle<K> box, int depth, double tolerance) : pqt(box, depth), tolerance(tolerance) {}
+
+	void reserve(int count) {
+		points.reserve(count);
+	}
+
+	int indexOf(const cartocrow::Point<K>& pt) {
+		Entry* entry = pqt.findElement(pt, tolerance);
+		if (entry == nullptr) {
+			entries.push_back({ pt, (int) points.size() });
+			entry = &entries.back();
+			pqt.insert(*entry);
+			points.push_back(pt);
+		}
+		return entry->index;
+	}
+
+	const std::vector<cartocrow::Point<K>>& getPoints() const {
+		return points;
+	}
+};
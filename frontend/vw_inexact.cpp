@@ -4,6 +4,8 @@
 #include "graph_painter.h"
 #include "smoother.h"
 
+#include <fstream>
+
 using namespace cartocrow::simplification;
 
 using VWGraph = HistoricVertexRemovalGraph<Inexact>;
@@ -41,8 +43,11 @@ void VWInexactSimplifier::initialize(InputGraph* graph, const int depth) {
 	m_pqt = new VWPQT(box, depth);
 
 	m_graph = new VWGraph(*m_base);
+	// checkpoints at intervals of 1/16 of the input, such that recalling any complexity replays few operations
+	m_graph->setCheckpointInterval(m_graph->getEdgeCount() / 16 + 1);
 
 	m_alg = new VW(*m_graph, *m_pqt);
+	m_alg->setThreadCount(m_base->getThreadCount());
 	m_alg->initialize(true);
 	m_reinit = false;
 
@@ -69,8 +74,8 @@ void VWInexactSimplifier::runToComplexity(const int k, std::optional<std::functi
 			if (m_graph->atPresent() && k < m_graph->getEdgeCount()) {
 				// see if there's more to perform
 				if (m_reinit) {
-					// recallComplexity was invoked, reinitialize algorithm
-					m_alg->initialize(true);
+					// recallComplexity was invoked, bring the algorithm up to date with the recalled graph
+					m_alg->resume();
 					m_reinit = false;
 				}
 
@@ -90,6 +95,67 @@ void VWInexactSimplifier::runToComplexity(const int k, std::optional<std::functi
 	}
 }
 
+void VWInexactSimplifier::runToThreshold(const Number<Inexact> t, std::optional<std::function<void(int)>> progress,
+	std::optional<std::function<bool()>> cancelled) {
+	if (hasResult()) {
+		clearSmoothResult();
+
+		if (!m_graph->atPresent() || m_graph->getMaxCost() > t) {
+			// recall known operations
+			m_graph->recallThreshold(t);
+			m_reinit = true;
+		}
+
+		if (m_graph->atPresent()) {
+			// see if there's more to perform
+			if (m_reinit) {
+				// recallThreshold was invoked, bring the algorithm up to date with the recalled graph
+				m_alg->resume();
+				m_reinit = false;
+			}
+
+			// already at present, run algorithm further
+			m_alg->run([&](int complexity, Number<Exact> cost) {
+				if (progress.has_value()) {
+					(*progress)(complexity);
+				}
+				if (cancelled.has_value() && (*cancelled)()) {
+					return true;
+				}
+
+				return cost > t;
+				});
+		}
+	}
+}
+
+bool VWInexactSimplifier::saveHistory(const std::filesystem::path& path) {
+	if (!hasResult()) {
+		return false;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	m_graph->write(file);
+	return (bool)file;
+}
+
+bool VWInexactSimplifier::loadHistory(const std::filesystem::path& path) {
+	if (!hasResult()) {
+		return false;
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	// rejects histories recorded on another input, leaving the graph as is
+	if (!file || !m_graph->read(file)) {
+		return false;
+	}
+
+	clearSmoothResult();
+	// the graph was rebuilt, the algorithm is reinitialized when it resumes
+	m_reinit = true;
+	return true;
+}
+
 bool VWInexactSimplifier::hasResult() {
 	return m_graph != nullptr;
 }
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cartocrow/core/core.h>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cartocrow::simplification::binary_io {
+
+	/// <summary>
+	/// Writes zero bytes until the stream position is a multiple of 8.
+	/// </summary>
+	inline void pad(std::ostream& os, std::uint64_t written) {
+		static const char zeros[8] = {};
+		if (written % 8 != 0) {
+			os.write(zeros, 8 - written % 8);
+		}
+	}
+
+	inline bool skipPadding(std::istream& is, std::uint64_t read) {
+		char buffer[8];
+		if (read % 8 != 0) {
+			is.read(buffer, 8 - read % 8);
+		}
+		return (bool)is;
+	}
+
+	template <typename T> void write(std::ostream& os, const T& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T> bool read(std::istream& is, T& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		is.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return (bool)is;
+	}
+
+	/// <summary>
+	/// Writes the values consecutively, followed by padding to the next 8-byte boundary.
+	/// </summary>
+	template <typename T> void writeArray(std::ostream& os, const T* values, std::uint64_t count) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		os.write(reinterpret_cast<const char*>(values), count * sizeof(T));
+		pad(os, count * sizeof(T));
+	}
+
+	template <typename T> bool readArray(std::istream& is, T* values, std::uint64_t count) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		is.read(reinterpret_cast<char*>(values), count * sizeof(T));
+		return (bool)is && skipPadding(is, count * sizeof(T));
+	}
+
+	/// <summary>
+	/// Writes the number of values, followed by the values as an array.
+	/// </summary>
+	template <typename T> void writeVector(std::ostream& os, const std::vector<T>& values) {
+		write<std::uint64_t>(os, values.size());
+		writeArray(os, values.data(), values.size());
+	}
+
+	template <typename T> bool readVector(std::istream& is, std::vector<T>& values, std::uint64_t max_count = 1 << 30) {
+		std::uint64_t count;
+		if (!read(is, count) || count > max_count) {
+			return false;
+		}
+		values.resize(count);
+		return readArray(is, values.data(), count);
+	}
+
+	inline void writeString(std::ostream& os, const std::string& str) {
+		write<std::uint64_t>(os, str.size());
+		writeArray(os, str.data(), str.size());
+	}
+
+	inline bool readString(std::istream& is, std::string& str, std::uint64_t max_length = 1 << 30) {
+		std::uint64_t length;
+		if (!read(is, length) || length > max_length) {
+			return false;
+		}
+		str.resize(length);
+		return readArray(is, str.data(), length);
+	}
+
+	/// <summary>
+	/// Whether the number equals its conversion to double, such that storing the double is lossless.
+	/// </summary>
+	template <typename K> bool isDouble(const Number<K>& x) {
+		return Number<K>(CGAL::to_double(x)) == x;
+	}
+
+	/// <summary>
+	/// Textual representation of the exact value of the number, to be parsed by parseNumber.
+	/// </summary>
+	template <typename K> std::string formatNumber(const Number<K>& x) {
+		std::ostringstream os;
+		os.precision(17);
+		os << CGAL::exact(x);
+		return os.str();
+	}
+
+	template <typename K> bool parseNumber(const std::string& str, Number<K>& x) {
+		std::istringstream is(str);
+		is >> x;
+		return !is.fail();
+	}
+
+	/// <summary>
+	/// Writes the number as a double, followed by its exact text if the double is not exact.
+	/// </summary>
+	template <typename K> void writeNumber(std::ostream& os, const Number<K>& x) {
+		bool exact = isDouble<K>(x);
+		write<double>(os, CGAL::to_double(x));
+		write<std::uint8_t>(os, exact);
+		if (!exact) {
+			writeString(os, formatNumber<K>(x));
+		}
+	}
+
+	template <typename K> bool readNumber(std::istream& is, Number<K>& x) {
+		double d;
+		std::uint8_t exact;
+		if (!read(is, d) || !read(is, exact)) {
+			return false;
+		}
+		if (exact) {
+			x = d;
+			return true;
+		}
+		std::string str;
+		return readString(is, str) && parseNumber<K>(str, x);
+	}
+
+} // namespace cartocrow::simplification::binary_io
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "slab_pool.h"
+
+namespace cartocrow::simplification::detail {
+
+	/// <summary>
+	/// A single blocking relation: the blocker prevents the operation on the blocked element.
+	/// Each link is part of two doubly-linked lists, the blocked_by list of the blocked element and the
+	/// blocking list of the blocker, such that it can be removed from both in constant time.
+	/// </summary>
+	template <class E> struct BlockingLink {
+		E* blocker;
+		E* blocked;
+		BlockingLink* prev_by;
+		BlockingLink* next_by;
+		BlockingLink* prev_ing;
+		BlockingLink* next_ing;
+	};
+
+	/// <summary>
+	/// Intrusive list of blocking links stored with an element. Iterating yields the elements at the other end of the links.
+	/// </summary>
+	/// <typeparam name="E">The element type</typeparam>
+	/// <typeparam name="ByBlocker">Whether this is a blocked_by list (listing blockers) or a blocking list (listing blocked elements)</typeparam>
+	template <class E, bool ByBlocker> class BlockingList {
+	public:
+		using Link = BlockingLink<E>;
+
+	private:
+		Link* head = nullptr;
+		int count = 0;
+
+		static Link*& next(Link* l) {
+			return ByBlocker ? l->next_by : l->next_ing;
+		}
+		static Link*& prev(Link* l) {
+			return ByBlocker ? l->prev_by : l->prev_ing;
+		}
+
+	public:
+		class iterator {
+		private:
+			Link* link;
+
+		public:
+			explicit iterator(Link* l) : link(l) {}
+
+			E* operator*() const {
+				return ByBlocker ? link->blocker : link->blocked;
+			}
+			iterator& operator++() {
+				link = next(link);
+				return *this;
+			}
+			bool operator!=(const iterator& other) const {
+				return link != other.link;
+			}
+		};
+
+		iterator begin() const {
+			return iterator(head);
+		}
+		iterator end() const {
+			return iterator(nullptr);
+		}
+
+		bool empty() const {
+			return head == nullptr;
+		}
+		int size() const {
+			return count;
+		}
+
+		Link* first() const {
+			return head;
+		}
+		static Link* following(Link* l) {
+			return next(l);
+		}
+
+		void insert(Link* l) {
+			prev(l) = nullptr;
+			next(l) = head;
+			if (head != nullptr) {
+				prev(head) = l;
+			}
+			head = l;
+			count++;
+		}
+
+		void erase(Link* l) {
+			if (prev(l) != nullptr) {
+				next(prev(l)) = next(l);
+			}
+			else {
+				head = next(l);
+			}
+			if (next(l) != nullptr) {
+				prev(next(l)) = prev(l);
+			}
+			count--;
+		}
+
+		/// <summary>
+		/// Forgets all links, without updating the lists at their other ends.
+		/// </summary>
+		void reset() {
+			head = nullptr;
+			count = 0;
+		}
+	};
+
+	template <class E> using BlockedByList = BlockingList<E, true>;
+	template <class E> using BlockingToList = BlockingList<E, false>;
+
+	/// <summary>
+	/// Owns the links of all blocking relations between elements of type E, which store their relations
+	/// in data().blocked_by (a BlockedByList) and data().blocking (a BlockingToList).
+	/// </summary>
+	template <class E> class BlockingRelations {
+	private:
+		using Link = BlockingLink<E>;
+
+		SlabPool<Link> pool;
+
+	public:
+		/// <summary>
+		/// Records that the blocker blocks the blocked element.
+		/// </summary>
+		void add(E* blocker, E* blocked) {
+			Link* l = pool.create();
+			l->blocker = blocker;
+			l->blocked = blocked;
+			blocked->data().blocked_by.insert(l);
+			blocker->data().blocking.insert(l);
+		}
+
+		/// <summary>
+		/// Removes all relations in which the element is blocked.
+		/// </summary>
+		void clearBlockedBy(E* e) {
+			auto& list = e->data().blocked_by;
+			Link* l = list.first();
+			while (l != nullptr) {
+				Link* nxt = BlockedByList<E>::following(l);
+				l->blocker->data().blocking.erase(l);
+				pool.destroy(l);
+				l = nxt;
+			}
+			list.reset();
+		}
+
+		/// <summary>
+		/// Removes all relations in which the element is the blocker. The callback is invoked with each
+		/// formerly blocked element, after the relation has been removed.
+		/// </summary>
+		template <typename F> void clearBlocking(E* e, F&& released) {
+			auto& list = e->data().blocking;
+			Link* l = list.first();
+			while (l != nullptr) {
+				Link* nxt = BlockingToList<E>::following(l);
+				E* blocked = l->blocked;
+				blocked->data().blocked_by.erase(l);
+				pool.destroy(l);
+				released(blocked);
+				l = nxt;
+			}
+			list.reset();
+		}
+
+		/// <summary>
+		/// Removes all relations at once. The lists stored with the elements must be reset by the caller.
+		/// </summary>
+		void clear() {
+			pool.clear();
+		}
+
+		int size() const {
+			return pool.size();
+		}
+	};
+
+} // namespace cartocrow::simplification::detail
@@ -1,7 +1,48 @@
 #pragma once
 
+#include <cartocrow/core/core.h>
+
 namespace cartocrow::simplification {
 
+	/// <summary>
+	/// Interval enclosing a cost, stored next to the cost such that queue comparisons rarely need its exact value.
+	/// </summary>
+	struct CostInterval {
+		double lo;
+		double hi;
+
+		template <typename K> static CostInterval of(const Number<K>& cost) {
+			auto [lo, hi] = CGAL::to_interval(cost);
+			return { lo, hi };
+		}
+	};
+
+	/// <summary>
+	/// Compares two costs by their intervals, and only by their exact values if the intervals overlap.
+	/// </summary>
+	template <typename K>
+	int compareCosts(const Number<K>& a, const CostInterval& ai, const Number<K>& b, const CostInterval& bi) {
+		if (ai.hi < bi.lo) {
+			return -1;
+		}
+		else if (ai.lo > bi.hi) {
+			return 1;
+		}
+		else if (ai.lo == ai.hi && bi.lo == bi.hi) {
+			// both intervals are points, which are the exact values
+			return 0;
+		}
+		else if (a < b) {
+			return -1;
+		}
+		else if (a > b) {
+			return 1;
+		}
+		else {
+			return 0;
+		}
+	}
+
 	template<class Elt, typename Kernel>
 	struct GraphQueueTraits {
 
@@ -16,17 +57,9 @@ namespace cartocrow::simplification {
 		}
 
 		static int compare(Elt* a, Elt* b) {
-			Number<Kernel> ac = a->data().cost;
-			Number<Kernel> bc = b->data().cost;
-			if (ac < bc) {
-				return -1;
-			}
-			else if (ac > bc) {
-				return 1;
-			}
-			else {
-				return 0;
-			}
+			auto& ad = a->data();
+			auto& bd = b->data();
+			return compareCosts<Kernel>(ad.cost, ad.cost_approx, bd.cost, bd.cost_approx);
 		}
 	};
 }
\ No newline at end of file
@@ -1,14 +1,21 @@
 #pragma once
 
 #include <cartocrow/core/core.h>
-#include <cartocrow/datastructures/indexed_priority_queue.h>
 
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+
+#include "elimination_sequence.h"
+#include "filtered_predicates.h"
 #include "vertex_quad_tree.h"
 #include "edge_quad_tree.h"
 #include "straight_graph.h"
 #include "modifiable_graph.h"
 #include "historic_graph.h"
+#include "indexed_heap.h"
 #include "common.h"
+#include "utils.h"
 
 namespace cartocrow::simplification {
 
@@ -23,6 +30,10 @@ namespace cartocrow::simplification {
 			e->data().cost
 		} -> std::same_as<Number<typename MG::Kernel>&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
 
+		{
+			e->data().cost_approx
+		} -> std::same_as<CostInterval&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
+
 		{
 			e->data().blocked_by
 		} -> std::same_as<std::vector<typename MG::Edge*>&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
@@ -63,7 +74,7 @@ namespace cartocrow::simplification {
 	using HistoricEdgeCollapseGraph = HistoricGraph<detail::HECGraph<K>>;
 
 
-	template <class MG, class ECT> requires detail::ECSetup<MG, ECT> class EdgeCollapse {
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT> class EdgeCollapse : private detail::HistoryObserverOf<MG>::type {
 	public:
 		using Vertex = MG::Vertex;
 		using Edge = MG::Edge;
@@ -75,22 +86,131 @@ namespace cartocrow::simplification {
 		MG& graph;
 		EdgeTree& sqt;
 		VertexTree& pqt;
-		cartocrow::datastructures::IndexedPriorityQueue<GraphQueueTraits<Edge, Kernel>> queue;
+		detail::IndexedHeap<GraphQueueTraits<Edge, Kernel>> queue;
+		int thread_count = 1;
+		utils::WorkerPool workers;
+		bool parallel_rounds = false;
+		double cost_slack = 0;
+		EliminationSequence<Kernel>* sequence = nullptr;
+		bool validate_blocking = false;
+		// counted concurrently by the blocking tests of parallel rounds
+		std::atomic<std::uint64_t> blocking_disagreements = 0;
+
+		// blocking tests of queued collapses performed ahead of time by findNextStep, valid until the graph changes
+		std::unordered_map<Edge*, int> speculated;
+		std::vector<Edge*> lookahead;
+		std::vector<std::vector<Edge*>> lookahead_blockers;
+		std::vector<char> lookahead_degzero;
+
+		// vertices around the changes made by recalling history, to be updated by resume(); once the graph was
+		// rebuilt or too many changes were made, the changes are no longer followed and resume() initializes
+		std::vector<Handle<Vertex>> touched;
+		bool rebuilt = false;
+
+		void touch(Vertex* v);
+		// removes the edge from the search structure, queue and blocking relations
+		void detach(Edge* e);
+		void attach(Edge* e);
+
+		// keeps the search structure, queue and blocking relations in sync while history is recalled
+		void beforeMerge(Vertex* v);
+		void afterMerge(Edge* e);
+		void beforeSplit(Edge* e);
+		void afterSplit(Vertex* v);
+		void beforeShift(Vertex* v);
+		void afterShift(Vertex* v);
+		void afterRebuild();
 
 		void update(Edge* e);
+		/// <summary>
+		/// Determines the collapse of the edge, and returns whether it can be collapsed at all. Only writes the data of the edge.
+		/// </summary>
+		bool evaluate(Edge* e);
 		bool blocks(Edge& edge, Edge* collapse);
+		/// <summary>
+		/// Tests whether the edge blocks the collapse with orientation tests only; the triangles must not be degenerate.
+		/// </summary>
+		bool blocksByPredicates(Edge& edge, Edge* collapse);
+		/// <summary>
+		/// Tests whether the edge blocks the collapse by constructing its intersections with the triangles.
+		/// </summary>
+		bool blocksByConstruction(Edge& edge, Edge* collapse);
 		bool validateState();
 
+		/// <summary>
+		/// Tests whether the collapse is blocked, collecting the blocking edges without recording the relations.
+		/// Returns whether it is blocked by a degree-0 vertex, in which case no edges are collected. Only reads shared state.
+		/// </summary>
+		bool findBlockers(Edge* e, std::vector<Edge*>& blockers);
+		void speculate();
 		Edge* findNextStep();
 		void performStep(Edge* e);
+		/// <summary>
+		/// Performs the (dequeued) collapse and updates the search structure and blocking relations, but not the costs:
+		/// the edges whose collapse changed are appended to affected, in the order in which they are to be updated.
+		/// </summary>
+		void collapse(Edge* e, std::vector<Edge*>& affected);
+		bool runRounds(std::optional<std::function<bool(int, Number<Kernel>)>> stop);
 	public:
 		EdgeCollapse(MG& g, EdgeTree& sqt, VertexTree& pqt);
 		~EdgeCollapse();
 
 		void initialize(bool initSQT, bool initPQT);
+		/// <summary>
+		/// Prepares the algorithm to run further after history was recalled, by updating only the edges around the
+		/// operations that were undone or redone; the edge search structure is kept up to date while recalling.
+		/// This takes time proportional to the number of recalled operations, rather than to the size of the graph.
+		/// If the graph was rebuilt from a checkpoint or a stream, or the recalled operations touched more than half of
+		/// its vertices, the algorithm is initialized from scratch instead.
+		/// Only the last algorithm constructed on a historic graph is kept up to date.
+		/// </summary>
+		void resume();
 		bool run(std::optional<std::function<bool(int,Number<Kernel>)>> stop = std::nullopt);
 		bool step();
 
+		/// <summary>
+		/// Sets the number of threads used by initialize, which determines the collapses of all edges concurrently.
+		/// With more than one thread, run also tests the blocking of the cheapest queued collapses concurrently
+		/// whenever the cheapest one turns out to be blocked; the results are used in order of cost, so the steps
+		/// are the same as with one thread. The threads are started here, and kept until the number changes.
+		/// </summary>
+		void setThreadCount(int threads);
+		int getThreadCount() const;
+
+		/// <summary>
+		/// Sets whether run works in rounds. Each round takes the cheapest collapses from the queue whose
+		/// neighborhoods (the two endpoints and their other neighbors) share no vertices and whose triangles do not
+		/// intersect, tests them for blocking concurrently, performs the unblocked ones in order of cost, and then
+		/// determines the changed collapses concurrently. Each round is a single history batch.
+		/// </summary>
+		void setParallelRounds(bool rounds);
+		bool getParallelRounds() const;
+
+		/// <summary>
+		/// Sets the relative cost slack of a round: a round only takes collapses with cost at most (1 + slack) times
+		/// the cheapest cost. A larger slack deviates more from the greedy order, but allows larger rounds.
+		/// </summary>
+		void setCostSlack(double slack);
+		double getCostSlack() const;
+
+		/// <summary>
+		/// Records the steps of subsequent runs into the sequence, which starts from the current state of the graph.
+		/// Pass nullptr to stop recording.
+		/// </summary>
+		void setEliminationSequence(EliminationSequence<Kernel>* seq);
+
+		/// <summary>
+		/// Sets whether blocking is tested by constructing intersections, as a reference for the tests by predicates.
+		/// Both tests are then performed and the constructions decide; enabling validation resets the count of
+		/// disagreements between the two.
+		/// </summary>
+		void setBlockingValidation(bool validate);
+		bool getBlockingValidation() const;
+
+		/// <summary>
+		/// The number of blocking tests on which the predicates disagreed with the constructions while validating.
+		/// </summary>
+		std::uint64_t getBlockingDisagreements() const;
 	};
 
 
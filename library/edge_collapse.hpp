@@ -3,6 +3,8 @@
 // Do not include this file, but the .h file instead
 // -----------------------------------------------------------------------------
 
+#include <unordered_set>
+
 #include "utils.h"
 
 namespace cartocrow::simplification {
@@ -16,6 +18,7 @@ namespace cartocrow::simplification {
 			bool creates_difference; // special case: when the edge is collinear with its neighbors, there are no difference-triangles
 			Triangle<K> T1, T2; // the two triangles of difference
 			Number<K> cost; // the cost of the collapse
+			CostInterval cost_approx; // encloses the cost, for cheap comparisons
 
 			// algorithm 
 			bool blocked_by_degzero;
@@ -30,7 +33,7 @@ namespace cartocrow::simplification {
 		};
 
 		template <typename K> struct HECData : ECBase<typename HECGraph<K>::Edge, K> {
-			Operation<HECGraph<K>>* hist = nullptr;
+			int hist = -1;
 		};
 	}
 
@@ -45,20 +48,90 @@ namespace cartocrow::simplification {
 		}
 		edata.blocked_by.clear();
 
+		if (!evaluate(e)) {
+			queue.remove(e);
+		}
+		else if (queue.contains(e)) {
+			queue.update(e);
+		}
+		else {
+			queue.push(e);
+		}
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	bool EdgeCollapse<MG, ECT>::evaluate(Edge* e) {
+
 		// last condition checks for a triangle
 		if (e->getSource()->degree() != 2 || e->getTarget()->degree() != 2 ||
 			e->sourceWalkNeighbor() == e->targetWalkNeighbor()) {
-			queue.remove(e);
-			return;
+			return false;
 		}
 
 		ECT::determineCollapse(e);
+		e->data().cost_approx = CostInterval::of<Kernel>(e->data().cost);
+		return true;
+	}
 
-		if (queue.contains(e)) {
-			queue.update(e);
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::setThreadCount(int threads) {
+		thread_count = std::max(1, threads);
+		workers.resize(thread_count);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	int EdgeCollapse<MG, ECT>::getThreadCount() const {
+		return thread_count;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::setParallelRounds(bool rounds) {
+		parallel_rounds = rounds;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	bool EdgeCollapse<MG, ECT>::getParallelRounds() const {
+		return parallel_rounds;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::setCostSlack(double slack) {
+		cost_slack = std::max(0.0, slack);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	double EdgeCollapse<MG, ECT>::getCostSlack() const {
+		return cost_slack;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::setBlockingValidation(bool validate) {
+		validate_blocking = validate;
+		if (validate) {
+			blocking_disagreements = 0;
 		}
-		else {
-			queue.push(e);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	bool EdgeCollapse<MG, ECT>::getBlockingValidation() const {
+		return validate_blocking;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	std::uint64_t EdgeCollapse<MG, ECT>::getBlockingDisagreements() const {
+		return blocking_disagreements;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::setEliminationSequence(EliminationSequence<Kernel>* seq) {
+		sequence = seq;
+		if (sequence != nullptr) {
+			if constexpr (ModifiableGraphWithHistory<MG>) {
+				sequence->start(graph.getBaseGraph());
+			}
+			else {
+				sequence->start(graph);
+			}
 		}
 	}
 
@@ -72,6 +145,76 @@ namespace cartocrow::simplification {
 			return false;
 		}
 
+		auto& cdata = collapse->data();
+		if (cdata.T1.orientation() == CGAL::COLLINEAR || cdata.T2.orientation() == CGAL::COLLINEAR) {
+			// degenerate triangles are left to the constructions
+			return blocksByConstruction(edge, collapse);
+		}
+
+		if (validate_blocking) {
+			bool expected = blocksByConstruction(edge, collapse);
+			if (blocksByPredicates(edge, collapse) != expected) {
+				blocking_disagreements++;
+			}
+			return expected;
+		}
+
+		return blocksByPredicates(edge, collapse);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	bool EdgeCollapse<MG, ECT>::blocksByPredicates(Edge& edge, Edge* collapse) {
+		Vertex* prev_v = collapse->previous()->getSource();
+		Vertex* next_v = collapse->next()->getTarget();
+
+		bool source_shared = edge.getSource() == prev_v || edge.getSource() == next_v;
+		bool target_shared = edge.getTarget() == prev_v || edge.getTarget() == next_v;
+
+		const Point<Kernel>& s = edge.getSource()->getPoint();
+		const Point<Kernel>& t = edge.getTarget()->getPoint();
+
+		auto test = [&](const Triangle<Kernel>& T) {
+			if (!CGAL::do_intersect(T, edge.getSegment())) {
+				// certainly no intersection
+				return false;
+			}
+
+			// the only common point is a shared endpoint
+			if (source_shared && detail::meetsTriangleOnlyAt(T, s, t)) {
+				return false;
+			}
+			if (target_shared && detail::meetsTriangleOnlyAt(T, t, s)) {
+				return false;
+			}
+
+			return true;
+			};
+
+		if (!test(collapse->data().T1) && !test(collapse->data().T2)) {
+			return false;
+		}
+
+		if constexpr (std::is_same<Inexact, Kernel>::value) {
+			// running in inexact mode: the triangles are constructed approximately, so the constructions decide
+			// whether an intersection near a shared endpoint is only an artifact of rounding
+			if (source_shared || target_shared) {
+				return blocksByConstruction(edge, collapse);
+			}
+		}
+
+		return true;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	bool EdgeCollapse<MG, ECT>::blocksByConstruction(Edge& edge, Edge* collapse) {
+		Edge* prev = collapse->sourceWalk();
+		Edge* next = collapse->targetWalk();
+
+		if (&edge == collapse || &edge == prev || &edge == next) {
+			// involved in collapse
+			return false;
+		}
+
 		Vertex* prev_v = collapse->previous()->getSource();
 		Vertex* next_v = collapse->next()->getTarget();;
 
@@ -159,11 +302,19 @@ namespace cartocrow::simplification {
 	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
 	EdgeCollapse<MG, ECT>::EdgeCollapse(MG& g, EdgeTree& sqt, VertexTree& pqt)
 		: graph(g), sqt(sqt), pqt(pqt) {
-
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			graph.setObserver(this);
+		}
 	}
 
 	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
-	EdgeCollapse<MG, ECT>::~EdgeCollapse() {}
+	EdgeCollapse<MG, ECT>::~EdgeCollapse() {
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			if (graph.getObserver() == this) {
+				graph.setObserver(nullptr);
+			}
+		}
+	}
 
 	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
 	void EdgeCollapse<MG, ECT>::initialize(bool initSQT, bool initPQT) {
@@ -184,20 +335,171 @@ namespace cartocrow::simplification {
 			}
 		}
 
-		queue.clear();
-
-		for (Edge* e : graph.getEdges()) {
+		// the collapses are independent, determine them concurrently before building the queue in one go
+		std::vector<Edge*>& edges = graph.getEdges();
+		std::vector<char> collapsible(edges.size());
+		workers.parallelFor(edges.size(), [&](int i) {
+			Edge* e = edges[i];
 			e->data().qid = -1;
 			e->data().blocked_by.clear();
 			e->data().blocking.clear();
 			e->data().blocked_by_degzero = false;
 
-			update(e);
+			collapsible[i] = evaluate(e);
+			});
+
+		std::vector<Edge*> queued;
+		for (int i = 0; i < edges.size(); i++) {
+			if (collapsible[i]) {
+				queued.push_back(edges[i]);
+			}
 		}
+		queue.build(std::move(queued));
+
+		touched.clear();
+		rebuilt = false;
 
 		assert(validateState());
 	}
 
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::resume() {
+		if (rebuilt) {
+			initialize(true, true);
+			return;
+		}
+
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			// the collapse of an edge depends on the vertices up to one edge away from its endpoints
+			for (Handle<Vertex> h : touched) {
+				Vertex* v = graph.getBaseGraph().resolve(h);
+				if (v == nullptr) {
+					continue;
+				}
+				for (int i = 0; i < v->degree(); i++) {
+					Vertex* u = v->neighbor(i);
+					for (int j = 0; j < u->degree(); j++) {
+						update(u->edge(j));
+					}
+				}
+			}
+		}
+		touched.clear();
+
+		assert(validateState());
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::touch(Vertex* v) {
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			touched.push_back(graph.getBaseGraph().getHandle(v));
+
+			// resume() updates the edges around each touched vertex, so beyond half the graph it costs more than
+			// initializing; stop following the changes then, which also bounds the memory spent on them
+			if (2 * touched.size() > graph.getVertices().size()) {
+				rebuilt = true;
+				touched.clear();
+				touched.shrink_to_fit();
+			}
+		}
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::detach(Edge* e) {
+		auto& edata = e->data();
+
+		sqt.remove(*e);
+		queue.remove(e);
+
+		// the edges blocked by this one are tested again once they reach the front of the queue
+		for (Edge* b : edata.blocking) {
+			if (utils::listRemove(e, b->data().blocked_by)) {
+				if (b->data().blocked_by.empty() && !b->data().blocked_by_degzero) {
+					queue.push(b);
+				}
+			}
+		}
+		edata.blocking.clear();
+
+		for (Edge* b : edata.blocked_by) {
+			utils::listRemove(e, b->data().blocking);
+		}
+		edata.blocked_by.clear();
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::attach(Edge* e) {
+		auto& edata = e->data();
+		edata.qid = -1;
+		edata.blocked_by.clear();
+		edata.blocking.clear();
+		edata.blocked_by_degzero = false;
+		sqt.insert(*e);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::beforeMerge(Vertex* v) {
+		if (rebuilt) {
+			return;
+		}
+		touch(v->previous());
+		touch(v->next());
+		detach(v->incoming());
+		detach(v->outgoing());
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::afterMerge(Edge* e) {
+		if (rebuilt) {
+			return;
+		}
+		attach(e);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::beforeSplit(Edge* e) {
+		if (rebuilt) {
+			return;
+		}
+		detach(e);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::afterSplit(Vertex* v) {
+		if (rebuilt) {
+			return;
+		}
+		attach(v->incoming());
+		attach(v->outgoing());
+		touch(v);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::beforeShift(Vertex* v) {
+		if (rebuilt) {
+			return;
+		}
+		detach(v->incoming());
+		detach(v->outgoing());
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::afterShift(Vertex* v) {
+		if (rebuilt) {
+			return;
+		}
+		attach(v->incoming());
+		attach(v->outgoing());
+		touch(v);
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::afterRebuild() {
+		// nothing refers to the new elements yet; the search structures are rebuilt by resume()
+		rebuilt = true;
+		touched.clear();
+	}
+
 	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
 	bool EdgeCollapse<MG, ECT>::validateState() {
 		bool ok = true;
@@ -232,6 +534,10 @@ namespace cartocrow::simplification {
 
 	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
 	bool EdgeCollapse<MG, ECT>::run(std::optional<std::function<bool(int, Number<Kernel>)>> stop) {
+		if (parallel_rounds) {
+			return runRounds(stop);
+		}
+
 		while (true) {
 			assert(validateState());
 
@@ -254,40 +560,265 @@ namespace cartocrow::simplification {
 	}
 
 	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
-	MG::Edge* EdgeCollapse<MG, ECT>::findNextStep() {
+	bool EdgeCollapse<MG, ECT>::runRounds(std::optional<std::function<bool(int, Number<Kernel>)>> stop) {
 		if constexpr (ModifiableGraphWithHistory<MG>) {
 			assert(graph.atPresent());
 		}
 
+		const int round_size = 64 * thread_count;
+
+		std::vector<Edge*> candidates;
+		std::vector<Edge*> deferred;
+		std::vector<Rectangle<Kernel>> boxes;
+		std::vector<std::vector<Edge*>> blockers;
+		std::vector<char> degzero;
+		std::vector<Edge*> performed;
+		std::vector<Edge*> affected;
+		std::vector<Edge*> changed;
+		std::vector<char> collapsible;
+		std::unordered_set<Vertex*> claimed;
+		std::unordered_set<Edge*> seen;
+
+		// whether the triangles of two collapses intersect; degenerate triangles are only compared by their boxes
+		auto overlap = [](Triangle<Kernel>& T, Triangle<Kernel>& U) {
+			return T.orientation() == CGAL::COLLINEAR || U.orientation() == CGAL::COLLINEAR || CGAL::do_intersect(T, U);
+			};
+
 		while (!queue.empty()) {
-			Edge* e = queue.peek();
+			assert(validateState());
 
-			auto& edata = e->data();
+			// select the cheapest collapses within the slack, such that no two neighborhoods share a vertex and no two
+			// triangles intersect: performing one then changes neither the collapse nor the blocking status of another,
+			// as its new edges lie on the boundary of its triangles
+			Number<Kernel> limit = queue.peek()->data().cost * (1 + cost_slack);
+			candidates.clear();
+			deferred.clear();
+			boxes.clear();
+			claimed.clear();
+			while (!queue.empty() && candidates.size() + deferred.size() < round_size) {
+				Edge* e = queue.peek();
+				auto& edata = e->data();
+				if (!candidates.empty() && edata.cost > limit) {
+					break;
+				}
+				queue.pop();
 
-			if (edata.creates_difference) {
-				// possibly blocked?
+				Vertex* nbh[4] = { e->previous()->getSource(), e->getSource(), e->getTarget(), e->next()->getTarget() };
+				bool conflict = std::any_of(nbh, nbh + 4, [&claimed](Vertex* v) { return claimed.contains(v); });
+
+				Rectangle<Kernel> box = edata.creates_difference ? utils::boxOf(edata.T1, edata.T2) : Rectangle<Kernel>();
+				for (int i = 0; !conflict && edata.creates_difference && i < candidates.size(); i++) {
+					auto& cdata = candidates[i]->data();
+					if (cdata.creates_difference && !utils::disjoint(box, boxes[i])) {
+						conflict = overlap(edata.T1, cdata.T1) || overlap(edata.T1, cdata.T2)
+							|| overlap(edata.T2, cdata.T1) || overlap(edata.T2, cdata.T2);
+					}
+				}
+
+				if (conflict) {
+					deferred.push_back(e);
+				}
+				else {
+					claimed.insert(nbh, nbh + 4);
+					candidates.push_back(e);
+					boxes.push_back(box);
+				}
+			}
+
+			// return conflicting collapses before modifying the graph, such that the updates below see them as queued
+			for (Edge* e : deferred) {
+				queue.push(e);
+			}
 
-				Rectangle<Kernel> rect = utils::boxOf(edata.T1, edata.T2);
+			// the blocking tests only read the graph and search structures
+			int n = candidates.size();
+			blockers.resize(n);
+			degzero.resize(n);
+			workers.parallelFor(n, [&](int i) {
+				blockers[i].clear();
+				degzero[i] = candidates[i]->data().creates_difference && findBlockers(candidates[i], blockers[i]);
+				});
+
+			// record all blocking relations before collapsing anything, as a blocker may itself be collapsed in this round
+			for (int i = 0; i < n; i++) {
+				Edge* e = candidates[i];
+				if (e->data().creates_difference) {
+					e->data().blocked_by_degzero = degzero[i];
+				}
+				for (Edge* b : blockers[i]) {
+					b->data().blocking.push_back(e);
+					e->data().blocked_by.push_back(b);
+				}
+			}
+
+			// candidates were taken from the queue in order of cost; the unblocked ones are performed up to the stop
+			// condition, while the blocked ones stay out of the queue until released, possibly by a collapse in this round
+			performed.clear();
+			int complexity = graph.getEdgeCount();
+			bool stopped = false;
+			for (int i = 0; i < n; i++) {
+				Edge* e = candidates[i];
+				if (degzero[i] || !blockers[i].empty()) {
+					continue;
+				}
 
-				edata.blocked_by_degzero = false;
+				if (stopped || !stop.has_value() || (*stop)(complexity, e->data().cost)) {
+					stopped = true;
+					queue.push(e);
+					continue;
+				}
+
+				performed.push_back(e);
+				complexity -= e->data().erase_both ? 2 : 1;
+			}
+
+			if (!performed.empty()) {
+				// the round is one step in history, at the cost of its most expensive collapse
+				if constexpr (ModifiableGraphWithHistory<MG>) {
+					graph.startBatch(performed.back()->data().cost);
+				}
+
+				affected.clear();
+				for (Edge* e : performed) {
+					collapse(e, affected);
+
+					if (sequence != nullptr) {
+						sequence->endStep(graph.getEdgeCount());
+					}
+				}
+
+				if constexpr (ModifiableGraphWithHistory<MG>) {
+					graph.endBatch();
+				}
+
+				// edges between two neighborhoods are affected by both collapses
+				changed.clear();
+				seen.clear();
+				for (Edge* e : affected) {
+					if (seen.insert(e).second) {
+						changed.push_back(e);
+					}
+				}
 
-				pqt.findContained(rect, [&edata](Vertex& b) {
-					if (!edata.T1.has_on_unbounded_side(b.getPoint()) ||
-						!edata.T2.has_on_unbounded_side(b.getPoint())) {
-						// blocked, by an unmovable vertex
-						edata.blocked_by_degzero = true;
+				// determine the changed collapses concurrently, as in initialize; only the topology is shared
+				for (Edge* e : changed) {
+					for (Edge* b : e->data().blocked_by) {
+						utils::listRemove(e, b->data().blocking);
 					}
+					e->data().blocked_by.clear();
+				}
+
+				int m = changed.size();
+				collapsible.resize(m);
+				workers.parallelFor(m, [&](int i) {
+					collapsible[i] = evaluate(changed[i]);
 					});
 
-				if (!edata.blocked_by_degzero) {
+				for (int i = 0; i < m; i++) {
+					Edge* e = changed[i];
+					if (!collapsible[i]) {
+						queue.remove(e);
+					}
+					else if (queue.contains(e)) {
+						queue.update(e);
+					}
+					else {
+						queue.push(e);
+					}
+				}
+			}
+
+			if (stopped) {
+				return true;
+			}
+		}
+
+		// no steps exist
+		return false;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	bool EdgeCollapse<MG, ECT>::findBlockers(Edge* e, std::vector<Edge*>& blockers) {
+		auto& edata = e->data();
+
+		Rectangle<Kernel> rect = utils::boxOf(edata.T1, edata.T2);
 
-					sqt.findOverlapped(rect, [this, &e](Edge& b) {
+		bool degzero = false;
+		pqt.findContained(rect, [&edata, &degzero](Vertex& b) {
+			if (!edata.T1.has_on_unbounded_side(b.getPoint()) ||
+				!edata.T2.has_on_unbounded_side(b.getPoint())) {
+				// blocked, by an unmovable vertex
+				degzero = true;
+			}
+			});
 
-						if (blocks(b, e)) {
-							b.data().blocking.push_back(e);
-							e->data().blocked_by.push_back(&b);
-						}
-						});
+		if (!degzero) {
+			sqt.findOverlapped(rect, [this, &e, &blockers](Edge& b) {
+				if (blocks(b, e)) {
+					blockers.push_back(&b);
+				}
+				});
+		}
+
+		return degzero;
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::speculate() {
+		// the cheapest queued collapses are likely to be at the front next, as long as they turn out to be blocked
+		queue.peekSmallest(8 * thread_count, lookahead);
+		std::erase_if(lookahead, [this](Edge* e) {
+			return !e->data().creates_difference || speculated.contains(e);
+			});
+
+		int first = lookahead_degzero.size();
+		int n = lookahead.size();
+		for (int i = 0; i < n; i++) {
+			speculated[lookahead[i]] = first + i;
+		}
+		lookahead_blockers.resize(first + n);
+		lookahead_degzero.resize(first + n);
+
+		// the tests only read the graph and search structures
+		workers.parallelFor(n, [&](int i) {
+			lookahead_blockers[first + i].clear();
+			lookahead_degzero[first + i] = findBlockers(lookahead[i], lookahead_blockers[first + i]);
+			});
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	MG::Edge* EdgeCollapse<MG, ECT>::findNextStep() {
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			assert(graph.atPresent());
+		}
+
+		// the queue is only popped below, so tests performed ahead of time remain valid during this call
+		speculated.clear();
+		lookahead_degzero.clear();
+
+		std::vector<Edge*> blockers;
+
+		while (!queue.empty()) {
+			Edge* e = queue.peek();
+
+			auto& edata = e->data();
+
+			if (edata.creates_difference) {
+				// possibly blocked?
+
+				auto it = speculated.find(e);
+				if (it != speculated.end()) {
+					edata.blocked_by_degzero = lookahead_degzero[it->second];
+					blockers.swap(lookahead_blockers[it->second]);
+				}
+				else {
+					blockers.clear();
+					edata.blocked_by_degzero = findBlockers(e, blockers);
+				}
+
+				for (Edge* b : blockers) {
+					b->data().blocking.push_back(e);
+					edata.blocked_by.push_back(b);
 				}
 
 			} // else: no difference, cannot be blocked
@@ -299,6 +830,11 @@ namespace cartocrow::simplification {
 			else {
 				// remove the element from the queue as it's not valid and continue searching
 				queue.pop();
+
+				// consecutive blocked collapses are common on dense inputs, test the next ones concurrently
+				if (thread_count > 1 && !queue.empty() && !speculated.contains(queue.peek())) {
+					speculate();
+				}
 			}
 		}
 
@@ -316,6 +852,27 @@ namespace cartocrow::simplification {
 
 		queue.pop();
 
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			graph.startBatch(e->data().cost);
+		}
+
+		std::vector<Edge*> affected;
+		collapse(e, affected);
+		for (Edge* a : affected) {
+			update(a);
+		}
+
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			graph.endBatch();
+		}
+
+		if (sequence != nullptr) {
+			sequence->endStep(graph.getEdgeCount());
+		}
+	}
+
+	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
+	void EdgeCollapse<MG, ECT>::collapse(Edge* e, std::vector<Edge*>& affected) {
 		auto& edata = e->data();
 
 		// remove from blocking lists and search structure
@@ -355,15 +912,16 @@ namespace cartocrow::simplification {
 		}
 		next->data().blocking.clear();
 
-		if constexpr (ModifiableGraphWithHistory<MG>) {
-			graph.startBatch(edata.cost);
-		}
-
 		Vertex* src = e->getSource();
 		Vertex* tar = e->getTarget();
 
 		if (edata.erase_both) {
 
+			if (sequence != nullptr) {
+				sequence->remove(src);
+				sequence->remove(tar);
+			}
+
 			graph.mergeVertex(src);
 			Edge* ne = graph.mergeVertex(tar);
 
@@ -371,12 +929,12 @@ namespace cartocrow::simplification {
 			sqt.insert(*ne);
 
 			// update it and its neighbors, if applicable
-			update(ne);
+			affected.push_back(ne);
 			if (ne->getSource()->degree() == 2) {
-				update(ne->previous());
+				affected.push_back(ne->previous());
 			}
 			if (ne->getTarget()->degree() == 2) {
-				update(ne->next());
+				affected.push_back(ne->next());
 			}
 		}
 		else {
@@ -384,6 +942,11 @@ namespace cartocrow::simplification {
 			// NB: edata will be erased on removing vertex b, hence, we need a local copy
 			Point<Kernel> pt = edata.point;
 
+			if (sequence != nullptr) {
+				sequence->remove(src);
+				sequence->relocate(tar, pt);
+			}
+
 			// perform the collapse
 			graph.mergeVertex(src);
 			graph.shiftVertex(tar, pt);
@@ -393,20 +956,16 @@ namespace cartocrow::simplification {
 			sqt.insert(*tar->outgoing());
 
 			// update them and their neighbors, if applicable
-			update(tar->incoming());
-			update(tar->outgoing());
+			affected.push_back(tar->incoming());
+			affected.push_back(tar->outgoing());
 
 			if (tar->previous()->degree() == 2) {
-				update(tar->previous()->incoming());
+				affected.push_back(tar->previous()->incoming());
 			}
 			if (tar->next()->degree() == 2) {
-				update(tar->next()->outgoing());
+				affected.push_back(tar->next()->outgoing());
 			}
 		}
-
-		if constexpr (ModifiableGraphWithHistory<MG>) {
-			graph.endBatch();
-		}
 	}
 
 	template <class MG, class ECT> requires detail::ECSetup<MG, ECT>
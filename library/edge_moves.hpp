@@ -35,6 +35,7 @@ namespace cartocrow::simplification {
 			MG::Edge* edge;
 
 			Number<typename MG::Kernel> cost;
+			CostInterval cost_approx;
 			int qid;
 
 			bool blocked_by_degzero;
@@ -352,7 +353,7 @@ namespace cartocrow::simplification {
 		};
 
 		template <typename K> struct HEMData : public EMBase<typename HEMGraph<K>> {
-			Operation<HEMGraph<K>>* hist = nullptr;
+			int hist = -1;
 		};
 
 		template<ModifiableGraph MG>
@@ -369,17 +370,7 @@ namespace cartocrow::simplification {
 			}
 
 			static int compare(Element* a, Element* b) {
-				Number<MG::Kernel> ac = a->cost;
-				Number<MG::Kernel> bc = b->cost;
-				if (ac < bc) {
-					return -1;
-				}
-				else if (ac > bc) {
-					return 1;
-				}
-				else {
-					return 0;
-				}
+				return compareCosts<typename MG::Kernel>(a->cost, a->cost_approx, b->cost, b->cost_approx);
 			}
 		};
 	} // namespace detail
@@ -398,6 +389,7 @@ namespace cartocrow::simplification {
 
 			if (left.movable()) {
 				EMT::determineSingleCost(left);
+				left.cost_approx = CostInterval::of<Kernel>(left.cost);
 
 				if (queue.contains(left)) {
 					queue.update(left);
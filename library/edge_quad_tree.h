@@ -2,6 +2,8 @@
 
 #include <cartocrow/datastructures/quad_tree.h>
 
+#include "utils.h"
+
 namespace cartocrow::simplification {
 
 	template<class Graph>
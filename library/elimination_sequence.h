@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cartocrow/core/core.h>
+
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+#include "graph_layout.h"
+
+namespace cartocrow::simplification {
+
+	/// <summary>
+	/// Progressive description of a simplification run, from which the graph at any complexity can be extracted without
+	/// replaying history. It stores, for every input vertex, the step in which it was removed, and the locations it was moved
+	/// to (by edge collapses) together with their steps. Vertices are only ever removed if they have degree 2, so the graph
+	/// after any step consists of the surviving vertices of each input chain, connected in their input order.
+	///
+	/// A sequence is recorded by passing it to VertexRemoval::setEliminationSequence or EdgeCollapse::setEliminationSequence,
+	/// and running the algorithm from its initial state without recalling history in between. Once finish() is called,
+	/// extract() only reads the sequence, and can be used by several threads concurrently.
+	/// </summary>
+	/// <typeparam name="K">The CGAL kernel of the graph</typeparam>
+	template <typename K> class EliminationSequence {
+	public:
+		static constexpr int NEVER = std::numeric_limits<int>::max();
+
+	private:
+		struct Relocation {
+			int vertex;
+			int step;
+			// the previous relocation of the same vertex, or -1
+			int previous;
+		};
+
+		// input graph
+		std::vector<Point<K>> points;
+		bool sorted = false;
+		int input_complexity = 0;
+
+		// vertices with degree other than 2, which are never removed; fixed_index maps input vertices to this list (or -1)
+		std::vector<int> fixed;
+		std::vector<int> fixed_index;
+		// per fixed vertex, its incident chain ends in input order, encoded as 2 * chain + (0: start, 1: end)
+		std::vector<int> fixed_offsets;
+		std::vector<int> fixed_ends;
+
+		// chains of input vertices, as in the boundaries of the oriented graph; chain c has its vertices in
+		// chain_vertices[chain_offsets[c]..chain_offsets[c+1]), and, once finished, its positions in the same
+		// range of chain_by_rank ordered by decreasing removal step
+		std::vector<int> chain_offsets;
+		std::vector<int> chain_vertices;
+		std::vector<int> chain_by_rank;
+		std::vector<std::uint8_t> chain_cyclic;
+
+		// recorded run
+		std::vector<int> slot_index;
+		std::vector<int> removal_step;
+		std::vector<int> last_relocation;
+		std::vector<Relocation> relocations;
+		std::vector<Point<K>> relocation_points;
+		std::vector<int> step_complexity;
+		bool finished = false;
+
+		int step() const {
+			return step_complexity.size() + 1;
+		}
+
+		const Point<K>& pointAt(int v, int s) const;
+
+	public:
+		/// <summary>
+		/// Starts recording on the given (oriented) graph, discarding any previous recording.
+		/// </summary>
+		template <class Graph> void start(Graph& graph);
+
+		/// <summary>
+		/// Records that the vertex is removed in the current step.
+		/// </summary>
+		template <class Vertex> void remove(Vertex* v);
+
+		/// <summary>
+		/// Records that the vertex moves to the given point in the current step.
+		/// </summary>
+		template <class Vertex> void relocate(Vertex* v, const Point<K>& pt);
+
+		/// <summary>
+		/// Ends the current step, after which the graph has the given complexity.
+		/// </summary>
+		void endStep(int complexity);
+
+		/// <summary>
+		/// Completes the recording, after which graphs can be extracted.
+		/// </summary>
+		void finish();
+		bool isFinished() const;
+
+		int getStepCount() const;
+		int getInputComplexity() const;
+		int getMinimumComplexity() const;
+
+		/// <summary>
+		/// The number of steps needed to reach at most the given complexity, or all steps if it cannot be reached.
+		/// </summary>
+		int stepsForComplexity(int complexity) const;
+
+		/// <summary>
+		/// The (oriented) graph after the given number of steps. Takes time proportional to the size of the output, up to
+		/// sorting the surviving vertices of each chain.
+		/// </summary>
+		GraphLayout<K> extract(int steps) const;
+
+		/// <summary>
+		/// The graph with at most the given complexity, or the final graph if that complexity cannot be reached.
+		/// </summary>
+		GraphLayout<K> extractComplexity(int complexity) const;
+
+		/// <summary>
+		/// Writes the finished sequence to the (binary) stream.
+		/// </summary>
+		void write(std::ostream& os) const;
+
+		/// <summary>
+		/// Reads a sequence written by write(). Returns false if the stream does not contain a valid sequence.
+		/// </summary>
+		bool read(std::istream& is);
+	};
+
+} // namespace cartocrow::simplification
+
+#include "elimination_sequence.hpp"
@@ -0,0 +1,408 @@
+// -----------------------------------------------------------------------------
+// IMPLEMENTATION OF TEMPLATE FUNCTIONS
+// Do not include this file, but the .h file instead
+// -----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+
+#include "binary_io.h"
+
+namespace cartocrow::simplification {
+
+	namespace detail {
+		constexpr char ELIMINATION_MAGIC[8] = { 'C', 'C', 'S', 'E', 'L', 'I', 'M', 'S' };
+		constexpr std::uint32_t ELIMINATION_VERSION = 1;
+	}
+
+	template <typename K>
+	template <class Graph>
+	void EliminationSequence<K>::start(Graph& graph) {
+		GraphLayout<K> layout = graph.exportLayout();
+		assert(layout.oriented);
+
+		points = std::move(layout.points);
+		sorted = layout.sorted;
+		input_complexity = layout.edges.size();
+		int n = points.size();
+
+		// walk the boundaries to list the vertices of each chain
+		std::vector<int> edge_chain(layout.edges.size(), -1);
+		std::vector<int> chain_first;
+		chain_offsets.assign(1, 0);
+		chain_vertices.clear();
+		chain_cyclic.clear();
+		for (auto& b : layout.boundaries) {
+			int c = chain_cyclic.size();
+			int e = b.first;
+			chain_first.push_back(e);
+			chain_vertices.push_back(layout.edges[e].first);
+			while (true) {
+				edge_chain[e] = c;
+				int t = layout.edges[e].second;
+				if (e == b.last) {
+					if (!b.cyclic) {
+						chain_vertices.push_back(t);
+					}
+					break;
+				}
+				chain_vertices.push_back(t);
+				// t has degree 2, and its incoming edge comes first
+				e = layout.incident[layout.incident_offsets[t] + 1];
+			}
+			chain_offsets.push_back(chain_vertices.size());
+			chain_cyclic.push_back(b.cyclic);
+		}
+
+		fixed.clear();
+		fixed_index.assign(n, -1);
+		fixed_offsets.assign(1, 0);
+		fixed_ends.clear();
+		for (int v = 0; v < n; v++) {
+			if (layout.incident_offsets[v + 1] - layout.incident_offsets[v] == 2) {
+				continue;
+			}
+			fixed_index[v] = fixed.size();
+			fixed.push_back(v);
+			for (int i = layout.incident_offsets[v]; i < layout.incident_offsets[v + 1]; i++) {
+				int e = layout.incident[i];
+				int c = edge_chain[e];
+				bool at_start = e == chain_first[c] && layout.edges[e].first == v;
+				fixed_ends.push_back(2 * c + (at_start ? 0 : 1));
+			}
+			fixed_offsets.push_back(fixed_ends.size());
+		}
+
+		std::vector<typename Graph::Vertex*>& vertices = graph.getVertices();
+		slot_index.assign(graph.getVertexSlotCount(), -1);
+		for (int i = 0; i < n; i++) {
+			slot_index[vertices[i]->handleSlot()] = i;
+		}
+
+		removal_step.assign(n, NEVER);
+		last_relocation.assign(n, -1);
+		relocations.clear();
+		relocation_points.clear();
+		step_complexity.clear();
+		chain_by_rank.clear();
+		finished = false;
+	}
+
+	template <typename K>
+	template <class Vertex>
+	void EliminationSequence<K>::remove(Vertex* v) {
+		assert(!finished);
+		removal_step[slot_index[v->handleSlot()]] = step();
+	}
+
+	template <typename K>
+	template <class Vertex>
+	void EliminationSequence<K>::relocate(Vertex* v, const Point<K>& pt) {
+		assert(!finished);
+		int i = slot_index[v->handleSlot()];
+		relocations.push_back({ i, step(), last_relocation[i] });
+		relocation_points.push_back(pt);
+		last_relocation[i] = relocations.size() - 1;
+	}
+
+	template <typename K>
+	void EliminationSequence<K>::endStep(int complexity) {
+		assert(!finished);
+		step_complexity.push_back(complexity);
+	}
+
+	template <typename K>
+	void EliminationSequence<K>::finish() {
+		chain_by_rank.resize(chain_vertices.size());
+		for (int c = 0; c + 1 < chain_offsets.size(); c++) {
+			int begin = chain_offsets[c];
+			int end = chain_offsets[c + 1];
+			for (int i = begin; i < end; i++) {
+				chain_by_rank[i] = i - begin;
+			}
+			std::stable_sort(chain_by_rank.begin() + begin, chain_by_rank.begin() + end, [&](int a, int b) {
+				return removal_step[chain_vertices[begin + a]] > removal_step[chain_vertices[begin + b]];
+				});
+		}
+
+		slot_index.clear();
+		slot_index.shrink_to_fit();
+		finished = true;
+	}
+
+	template <typename K>
+	bool EliminationSequence<K>::isFinished() const {
+		return finished;
+	}
+
+	template <typename K>
+	int EliminationSequence<K>::getStepCount() const {
+		return step_complexity.size();
+	}
+
+	template <typename K>
+	int EliminationSequence<K>::getInputComplexity() const {
+		return input_complexity;
+	}
+
+	template <typename K>
+	int EliminationSequence<K>::getMinimumComplexity() const {
+		return step_complexity.empty() ? input_complexity : step_complexity.back();
+	}
+
+	template <typename K>
+	int EliminationSequence<K>::stepsForComplexity(int complexity) const {
+		if (complexity >= input_complexity) {
+			return 0;
+		}
+		// complexities do not increase over the steps
+		auto it = std::partition_point(step_complexity.begin(), step_complexity.end(), [complexity](int c) {
+			return c > complexity;
+			});
+		return it == step_complexity.end() ? step_complexity.size() : (it - step_complexity.begin()) + 1;
+	}
+
+	template <typename K>
+	const Point<K>& EliminationSequence<K>::pointAt(int v, int s) const {
+		int r = last_relocation[v];
+		while (r >= 0 && relocations[r].step > s) {
+			r = relocations[r].previous;
+		}
+		return r >= 0 ? relocation_points[r] : points[v];
+	}
+
+	template <typename K>
+	GraphLayout<K> EliminationSequence<K>::extract(int steps) const {
+		assert(finished);
+
+		GraphLayout<K> layout;
+		layout.oriented = true;
+		layout.sorted = sorted;
+
+		for (int v : fixed) {
+			layout.points.push_back(pointAt(v, steps));
+		}
+
+		int chain_count = chain_cyclic.size();
+		std::vector<int> chain_first(chain_count), chain_last(chain_count);
+		// incoming and outgoing edge of the surviving degree-2 vertices, in order of creation
+		std::vector<std::pair<int, int>> interior;
+		std::vector<int> positions;
+		std::vector<int> indices;
+
+		for (int c = 0; c < chain_count; c++) {
+			int begin = chain_offsets[c];
+			int end = chain_offsets[c + 1];
+			int length = end - begin;
+			bool cyclic = chain_cyclic[c];
+
+			positions.clear();
+			for (int i = begin; i < end && removal_step[chain_vertices[begin + chain_by_rank[i]]] > steps; i++) {
+				positions.push_back(chain_by_rank[i]);
+			}
+			std::sort(positions.begin(), positions.end());
+
+			indices.clear();
+			int first_edge = layout.edges.size();
+			for (int k = 0; k < positions.size(); k++) {
+				int p = positions[k];
+				int v = chain_vertices[begin + p];
+				if (!cyclic && (p == 0 || p == length - 1)) {
+					indices.push_back(fixed_index[v]);
+				}
+				else {
+					int edge_count = cyclic ? positions.size() : positions.size() - 1;
+					int in = first_edge + (k + edge_count - 1) % edge_count;
+					int out = first_edge + k;
+					indices.push_back(layout.points.size());
+					layout.points.push_back(pointAt(v, steps));
+					interior.emplace_back(in, out);
+				}
+			}
+
+			for (int k = 0; k + 1 < indices.size(); k++) {
+				layout.edges.emplace_back(indices[k], indices[k + 1]);
+			}
+			if (cyclic) {
+				layout.edges.emplace_back(indices.back(), indices.front());
+			}
+
+			chain_first[c] = first_edge;
+			chain_last[c] = layout.edges.size() - 1;
+			layout.boundaries.push_back({ chain_first[c], chain_last[c], cyclic });
+		}
+
+		layout.incident_offsets.reserve(layout.points.size() + 1);
+		layout.incident_offsets.push_back(0);
+		for (int f = 0; f < fixed.size(); f++) {
+			for (int i = fixed_offsets[f]; i < fixed_offsets[f + 1]; i++) {
+				int end = fixed_ends[i];
+				layout.incident.push_back(end % 2 == 0 ? chain_first[end / 2] : chain_last[end / 2]);
+			}
+			layout.incident_offsets.push_back(layout.incident.size());
+		}
+		for (auto [in, out] : interior) {
+			layout.incident.push_back(in);
+			layout.incident.push_back(out);
+			layout.incident_offsets.push_back(layout.incident.size());
+		}
+
+		return layout;
+	}
+
+	template <typename K>
+	GraphLayout<K> EliminationSequence<K>::extractComplexity(int complexity) const {
+		return extract(stepsForComplexity(complexity));
+	}
+
+	template <typename K>
+	void EliminationSequence<K>::write(std::ostream& os) const {
+		assert(finished);
+
+		binary_io::writeArray(os, detail::ELIMINATION_MAGIC, 8);
+		binary_io::write<std::uint32_t>(os, detail::ELIMINATION_VERSION);
+		binary_io::write<std::uint8_t>(os, sorted);
+		binary_io::write<std::int32_t>(os, input_complexity);
+
+		binary_io::write<std::uint64_t>(os, points.size());
+		for (const Point<K>& pt : points) {
+			binary_io::writeNumber<K>(os, pt.x());
+			binary_io::writeNumber<K>(os, pt.y());
+		}
+
+		binary_io::writeVector(os, fixed);
+		binary_io::writeVector(os, fixed_offsets);
+		binary_io::writeVector(os, fixed_ends);
+		binary_io::writeVector(os, chain_offsets);
+		binary_io::writeVector(os, chain_vertices);
+		binary_io::writeVector(os, chain_by_rank);
+		binary_io::writeVector(os, chain_cyclic);
+		binary_io::writeVector(os, removal_step);
+		binary_io::writeVector(os, last_relocation);
+		binary_io::writeVector(os, relocations);
+		for (const Point<K>& pt : relocation_points) {
+			binary_io::writeNumber<K>(os, pt.x());
+			binary_io::writeNumber<K>(os, pt.y());
+		}
+		binary_io::writeVector(os, step_complexity);
+	}
+
+	template <typename K>
+	bool EliminationSequence<K>::read(std::istream& is) {
+		char magic[8];
+		std::uint32_t version;
+		std::uint8_t sorted_flag;
+		std::int32_t complexity;
+		std::uint64_t n;
+		if (!binary_io::readArray(is, magic, 8) || std::memcmp(magic, detail::ELIMINATION_MAGIC, 8) != 0
+			|| !binary_io::read(is, version) || version != detail::ELIMINATION_VERSION
+			|| !binary_io::read(is, sorted_flag) || !binary_io::read(is, complexity)
+			|| !binary_io::read(is, n) || n > std::numeric_limits<std::int32_t>::max()) {
+			return false;
+		}
+
+		auto readPoints = [&is](std::vector<Point<K>>& pts, std::uint64_t count) {
+			pts.clear();
+			pts.reserve(count);
+			for (std::uint64_t i = 0; i < count; i++) {
+				Number<K> x, y;
+				if (!binary_io::readNumber<K>(is, x) || !binary_io::readNumber<K>(is, y)) {
+					return false;
+				}
+				pts.emplace_back(x, y);
+			}
+			return true;
+		};
+
+		if (!readPoints(points, n)
+			|| !binary_io::readVector(is, fixed)
+			|| !binary_io::readVector(is, fixed_offsets)
+			|| !binary_io::readVector(is, fixed_ends)
+			|| !binary_io::readVector(is, chain_offsets)
+			|| !binary_io::readVector(is, chain_vertices)
+			|| !binary_io::readVector(is, chain_by_rank)
+			|| !binary_io::readVector(is, chain_cyclic)
+			|| !binary_io::readVector(is, removal_step)
+			|| !binary_io::readVector(is, last_relocation)
+			|| !binary_io::readVector(is, relocations)
+			|| !readPoints(relocation_points, relocations.size())
+			|| !binary_io::readVector(is, step_complexity)) {
+			return false;
+		}
+
+		// validate all indices, such that extraction needs no further checks
+		auto inRange = [](int i, std::uint64_t count) {
+			return 0 <= i && i < count;
+		};
+		auto isOffsets = [](const std::vector<int>& offsets, std::uint64_t count) {
+			return !offsets.empty() && offsets.front() == 0 && offsets.back() == count && std::ranges::is_sorted(offsets);
+		};
+		int chain_count = chain_cyclic.size();
+		if (removal_step.size() != n || last_relocation.size() != n
+			|| fixed_offsets.size() != fixed.size() + 1 || !isOffsets(fixed_offsets, fixed_ends.size())
+			|| chain_offsets.size() != chain_count + 1 || !isOffsets(chain_offsets, chain_vertices.size())
+			|| chain_by_rank.size() != chain_vertices.size()
+			|| !std::ranges::all_of(fixed, [&](int v) { return inRange(v, n); })
+			|| !std::ranges::all_of(fixed_ends, [&](int e) { return inRange(e, 2 * chain_count); })
+			|| !std::ranges::all_of(chain_vertices, [&](int v) { return inRange(v, n); })
+			|| !std::ranges::all_of(last_relocation, [&](int r) { return r == -1 || inRange(r, relocations.size()); })) {
+			return false;
+		}
+		int step_count = step_complexity.size();
+		if (!std::ranges::all_of(removal_step, [&](int s) { return s == NEVER || (1 <= s && s <= step_count); })
+			|| !std::ranges::all_of(fixed, [&](int v) { return removal_step[v] == NEVER; })) {
+			return false;
+		}
+		std::vector<std::uint8_t> ranked;
+		for (int c = 0; c < chain_count; c++) {
+			int begin = chain_offsets[c];
+			int length = chain_offsets[c + 1] - begin;
+			if (length < (chain_cyclic[c] ? 3 : 2)) {
+				return false;
+			}
+			// the ranks must list every position once, by decreasing removal step, as extraction stops at the first
+			// removed vertex
+			auto stepAt = [&](int i) {
+				return removal_step[chain_vertices[begin + chain_by_rank[i]]];
+			};
+			ranked.assign(length, false);
+			int kept = 0;
+			for (int i = begin; i < begin + length; i++) {
+				int p = chain_by_rank[i];
+				if (!inRange(p, length) || ranked[p] || (i > begin && stepAt(i - 1) < stepAt(i))) {
+					return false;
+				}
+				ranked[p] = true;
+				kept += stepAt(i) == NEVER;
+			}
+			// a cycle must keep a triangle after every step
+			if (chain_cyclic[c] && kept < 3) {
+				return false;
+			}
+		}
+		for (int r = 0; r < relocations.size(); r++) {
+			if (!inRange(relocations[r].vertex, n) || relocations[r].previous >= r) {
+				return false;
+			}
+		}
+
+		fixed_index.assign(n, -1);
+		for (int f = 0; f < fixed.size(); f++) {
+			fixed_index[fixed[f]] = f;
+		}
+		for (int c = 0; c < chain_count; c++) {
+			int first = chain_vertices[chain_offsets[c]];
+			int last = chain_vertices[chain_offsets[c + 1] - 1];
+			if (!chain_cyclic[c] && (fixed_index[first] < 0 || fixed_index[last] < 0)) {
+				return false;
+			}
+		}
+
+		sorted = sorted_flag != 0;
+		input_complexity = complexity;
+		slot_index.clear();
+		finished = true;
+		return true;
+	}
+
+} // namespace cartocrow::simplification
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cartocrow/core/core.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace cartocrow::simplification {
+
+	/// <summary>
+	/// Counts how often a filtered predicate was decided by its floating-point filter, and how often it had to fall back to the exact kernel.
+	/// </summary>
+	struct PredicateStats {
+		std::uint64_t filtered = 0;
+		std::uint64_t exact = 0;
+
+		void reset() {
+			filtered = 0;
+			exact = 0;
+		}
+	};
+
+	namespace detail {
+
+		/// <summary>
+		/// Sign of the orientation of (a, b, c), evaluated in double precision. Returns 0 if the sign cannot be certified,
+		/// and +1 or -1 otherwise; exact zeros are never certified. The error bound is that of Shewchuk's orient2d filter,
+		/// which is valid if the inputs are exactly representable as doubles and no underflow occurs.
+		/// </summary>
+		inline int filteredOrientation(double ax, double ay, double bx, double by, double cx, double cy) {
+			constexpr double epsilon = std::numeric_limits<double>::epsilon() / 2;
+			constexpr double bound = (3.0 + 16.0 * epsilon) * epsilon;
+
+			double left = (ax - cx) * (by - cy);
+			double right = (ay - cy) * (bx - cx);
+			double det = left - right;
+
+			double sum;
+			if (left > 0) {
+				if (right <= 0) {
+					return det > 0 ? 1 : 0;
+				}
+				sum = left + right;
+			}
+			else if (left < 0) {
+				if (right >= 0) {
+					return det < 0 ? -1 : 0;
+				}
+				sum = -left - right;
+			}
+			else {
+				// one of the factors is exactly zero
+				return right > 0 ? -1 : right < 0 ? 1 : 0;
+			}
+
+			double err = bound * sum;
+			if (det > err) {
+				return 1;
+			}
+			else if (-det > err) {
+				return -1;
+			}
+			else {
+				return 0;
+			}
+		}
+
+		/// <summary>
+		/// Converts the number to a double if that is lossless, and the kernel can tell so without exact evaluation.
+		/// </summary>
+		template <typename K> bool toExactDouble(const Number<K>& x, double& d) {
+			auto [lo, hi] = CGAL::to_interval(x);
+			d = lo;
+			return lo == hi && std::isfinite(lo);
+		}
+
+		/// <summary>
+		/// A triangle that tests whether points lie on its unbounded side, using the double-precision filter where it is
+		/// conclusive and the exact kernel otherwise. Degenerate triangles and triangles with coordinates that are not
+		/// doubles always use the exact kernel.
+		/// </summary>
+		template <typename K> class FilteredTriangle {
+		private:
+			Triangle<K> triangle;
+			double coords[6];
+			int orientation = 0;
+
+		public:
+			FilteredTriangle(const Point<K>& a, const Point<K>& b, const Point<K>& c) : triangle(a, b, c) {
+				const Point<K>* pts[3] = { &a, &b, &c };
+				for (int i = 0; i < 3; i++) {
+					if (!toExactDouble<K>(pts[i]->x(), coords[2 * i]) || !toExactDouble<K>(pts[i]->y(), coords[2 * i + 1])) {
+						return;
+					}
+				}
+				orientation = filteredOrientation(coords[0], coords[1], coords[2], coords[3], coords[4], coords[5]);
+			}
+
+			const Triangle<K>& getTriangle() const {
+				return triangle;
+			}
+
+			bool hasOnUnboundedSide(const Point<K>& p, PredicateStats& stats) const {
+				double px, py;
+				if (orientation != 0 && toExactDouble<K>(p.x(), px) && toExactDouble<K>(p.y(), py)) {
+					bool certain = true;
+					for (int i = 0; i < 3; i++) {
+						int j = (i + 1) % 3;
+						int side = filteredOrientation(coords[2 * i], coords[2 * i + 1], coords[2 * j], coords[2 * j + 1], px, py);
+						if (side == -orientation) {
+							// strictly on the outer side of one of the edges
+							stats.filtered++;
+							return true;
+						}
+						certain = certain && side == orientation;
+					}
+					if (certain) {
+						// strictly on the inner side of all edges
+						stats.filtered++;
+						return false;
+					}
+				}
+
+				stats.exact++;
+				return triangle.has_on_unbounded_side(p);
+			}
+		};
+
+		/// <summary>
+		/// Whether the segment pq meets the non-degenerate triangle in its endpoint p only. Uses orientation tests only: p
+		/// must lie in the triangle, and q strictly outside one of the edges whose supporting line contains p. Those
+		/// edges bound the cone of directions in which the triangle continues from p, so pq leaves it immediately.
+		/// </summary>
+		template <typename K> bool meetsTriangleOnlyAt(const Triangle<K>& T, const Point<K>& p, const Point<K>& q) {
+			if (T.has_on_unbounded_side(p)) {
+				return false;
+			}
+			for (int i = 0; i < 3; i++) {
+				const Point<K>& a = T.vertex(i);
+				const Point<K>& b = T.vertex(i + 1);
+				if (CGAL::orientation(a, b, p) == CGAL::COLLINEAR
+					&& CGAL::orientation(a, b, q) == -CGAL::orientation(a, b, T.vertex(i + 2))) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+	} // namespace detail
+
+} // namespace cartocrow::simplification
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cartocrow/core/core.h>
+
+namespace cartocrow::simplification {
+
+	/// <summary>
+	/// Flat, index-based description of a StraightGraph, including its orientation, incident-edge order and boundaries.
+	/// A graph built from the layout of another graph is identical to it, up to the vertex and edge data.
+	/// </summary>
+	template <typename K> struct GraphLayout {
+
+		struct BoundaryLayout {
+			int first;
+			int last;
+			bool cyclic;
+		};
+
+		std::vector<Point<K>> points;
+		// (source, target) per edge
+		std::vector<std::pair<int, int>> edges;
+		// incident edges of vertex i are incident[incident_offsets[i]..incident_offsets[i+1])
+		std::vector<int> incident_offsets;
+		std::vector<int> incident;
+		// only meaningful if the graph is oriented
+		std::vector<BoundaryLayout> boundaries;
+
+		bool oriented = false;
+		bool sorted = false;
+	};
+
+} // namespace cartocrow::simplification
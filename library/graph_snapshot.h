@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cartocrow/core/core.h>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "graph_layout.h"
+
+namespace cartocrow::simplification {
+
+	/// <summary>
+	/// Binary snapshot of a graph layout. All sections are arrays of fixed-width values in native byte order,
+	/// each starting at an 8-byte aligned offset, such that a memory-mapped file can be used as-is:
+	///
+	///   header       SnapshotHeader
+	///   xs, ys       double[vertex_count] each
+	///   edges        int32[2 * edge_count], (source, target) pairs
+	///   offsets      int32[vertex_count + 1], incident      int32[incident_count]
+	///   boundaries   int32[3 * boundary_count], (first, last, cyclic) triples
+	///   exact        exact_count records (vertex, coordinate, length, unused: int32 each; text: char[length])
+	///
+	/// Coordinates that are not exactly representable as a double are stored (also) in the exact section, as text,
+	/// such that snapshots of graphs with exact kernels are lossless.
+	/// </summary>
+	struct SnapshotHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t flags;
+		std::uint64_t vertex_count;
+		std::uint64_t edge_count;
+		std::uint64_t incident_count;
+		std::uint64_t boundary_count;
+		std::uint64_t exact_count;
+		std::uint64_t reserved;
+
+		static constexpr char MAGIC[8] = { 'C', 'C', 'S', 'G', 'R', 'A', 'P', 'H' };
+		static constexpr std::uint32_t VERSION = 1;
+		static constexpr std::uint32_t ORIENTED = 1;
+		static constexpr std::uint32_t SORTED = 2;
+	};
+
+	/// <summary>
+	/// Writes the layout as a snapshot to the (binary) stream.
+	/// </summary>
+	template <typename K> void writeSnapshot(std::ostream& os, const GraphLayout<K>& layout);
+
+	/// <summary>
+	/// Reads a snapshot from the (binary) stream into the layout. Returns false if the stream does not contain a valid snapshot.
+	/// </summary>
+	template <typename K> bool readSnapshot(std::istream& is, GraphLayout<K>& layout);
+
+} // namespace cartocrow::simplification
+
+#include "graph_snapshot.hpp"
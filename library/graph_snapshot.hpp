@@ -0,0 +1,252 @@
+// -----------------------------------------------------------------------------
+// IMPLEMENTATION OF TEMPLATE FUNCTIONS
+// Do not include this file, but the .h file instead
+// -----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "binary_io.h"
+
+namespace cartocrow::simplification {
+
+	namespace detail {
+		/// <summary>
+		/// Checks the structure of a layout whose indices are in range: the incident lists must contain every edge at
+		/// both of its endpoints and nowhere else, and if the layout is oriented, degree-2 vertices must have their
+		/// in-edge first and their out-edge second, and the boundaries must be chains that cover every edge exactly once.
+		/// Ensures that importLayout builds a consistent graph, and that walking its boundaries terminates.
+		/// </summary>
+		template <typename K> bool isConsistentLayout(const GraphLayout<K>& layout) {
+			int n = layout.points.size();
+			int m = layout.edges.size();
+			auto& offsets = layout.incident_offsets;
+			auto& incident = layout.incident;
+
+			if (incident.size() != 2 * m) {
+				return false;
+			}
+
+			// each edge occurs once in the list of its source and once in that of its target
+			std::vector<std::uint8_t> seen(m, 0);
+			for (int v = 0; v < n; v++) {
+				for (int j = offsets[v]; j < offsets[v + 1]; j++) {
+					auto [s, t] = layout.edges[incident[j]];
+					if (s == t) {
+						return false;
+					}
+					std::uint8_t side = s == v ? 1 : t == v ? 2 : 0;
+					if (side == 0 || (seen[incident[j]] & side) != 0) {
+						return false;
+					}
+					seen[incident[j]] |= side;
+				}
+			}
+
+			if (!layout.oriented) {
+				return true;
+			}
+
+			auto degree = [&](int v) {
+				return offsets[v + 1] - offsets[v];
+			};
+			for (int v = 0; v < n; v++) {
+				if (degree(v) == 2
+					&& (layout.edges[incident[offsets[v]]].second != v || layout.edges[incident[offsets[v] + 1]].first != v)) {
+					return false;
+				}
+			}
+
+			// walk each boundary from its first to its last edge, as importLayout does
+			std::vector<bool> covered(m, false);
+			int count = 0;
+			for (auto& b : layout.boundaries) {
+				int e = b.first;
+				while (true) {
+					if (covered[e]) {
+						return false;
+					}
+					covered[e] = true;
+					count++;
+					if (e == b.last) {
+						break;
+					}
+					int v = layout.edges[e].second;
+					if (degree(v) != 2) {
+						return false;
+					}
+					e = incident[offsets[v] + 1];
+				}
+			}
+			return count == m;
+		}
+	}
+
+	template <typename K> void writeSnapshot(std::ostream& os, const GraphLayout<K>& layout) {
+
+		std::uint64_t n = layout.points.size();
+
+		std::vector<double> xs(n), ys(n);
+		std::vector<std::tuple<int, int, std::string>> exact;
+		for (int i = 0; i < n; i++) {
+			const Point<K>& pt = layout.points[i];
+			xs[i] = CGAL::to_double(pt.x());
+			ys[i] = CGAL::to_double(pt.y());
+			if (!binary_io::isDouble<K>(pt.x())) {
+				exact.emplace_back(i, 0, binary_io::formatNumber<K>(pt.x()));
+			}
+			if (!binary_io::isDouble<K>(pt.y())) {
+				exact.emplace_back(i, 1, binary_io::formatNumber<K>(pt.y()));
+			}
+		}
+
+		SnapshotHeader header;
+		std::memcpy(header.magic, SnapshotHeader::MAGIC, 8);
+		header.version = SnapshotHeader::VERSION;
+		header.flags = (layout.oriented ? SnapshotHeader::ORIENTED : 0) | (layout.sorted ? SnapshotHeader::SORTED : 0);
+		header.vertex_count = n;
+		header.edge_count = layout.edges.size();
+		header.incident_count = layout.incident.size();
+		header.boundary_count = layout.oriented ? layout.boundaries.size() : 0;
+		header.exact_count = exact.size();
+		header.reserved = 0;
+		binary_io::write(os, header);
+
+		binary_io::writeArray(os, xs.data(), n);
+		binary_io::writeArray(os, ys.data(), n);
+
+		std::vector<std::int32_t> buffer;
+		buffer.reserve(2 * layout.edges.size());
+		for (auto [s, t] : layout.edges) {
+			buffer.push_back(s);
+			buffer.push_back(t);
+		}
+		binary_io::writeArray(os, buffer.data(), buffer.size());
+
+		buffer.assign(layout.incident_offsets.begin(), layout.incident_offsets.end());
+		binary_io::writeArray(os, buffer.data(), buffer.size());
+		buffer.assign(layout.incident.begin(), layout.incident.end());
+		binary_io::writeArray(os, buffer.data(), buffer.size());
+
+		buffer.clear();
+		for (int i = 0; i < header.boundary_count; i++) {
+			auto& b = layout.boundaries[i];
+			buffer.push_back(b.first);
+			buffer.push_back(b.last);
+			buffer.push_back(b.cyclic);
+		}
+		binary_io::writeArray(os, buffer.data(), buffer.size());
+
+		for (auto& [v, c, text] : exact) {
+			std::int32_t record[4] = { v, c, (std::int32_t)text.size(), 0 };
+			binary_io::write(os, record);
+			binary_io::writeArray(os, text.data(), text.size());
+		}
+	}
+
+	template <typename K> bool readSnapshot(std::istream& is, GraphLayout<K>& layout) {
+
+		SnapshotHeader header;
+		if (!binary_io::read(is, header)
+			|| std::memcmp(header.magic, SnapshotHeader::MAGIC, 8) != 0
+			|| header.version != SnapshotHeader::VERSION) {
+			return false;
+		}
+
+		// guard against corrupt counts before allocating
+		constexpr std::uint64_t max_count = std::numeric_limits<std::int32_t>::max();
+		std::uint64_t n = header.vertex_count;
+		std::uint64_t m = header.edge_count;
+		if (n > max_count || m > max_count || header.incident_count > 2 * m || header.boundary_count > m || header.exact_count > 2 * n) {
+			return false;
+		}
+
+		std::vector<double> xs(n), ys(n);
+		if (!binary_io::readArray(is, xs.data(), n) || !binary_io::readArray(is, ys.data(), n)) {
+			return false;
+		}
+
+		std::vector<std::int32_t> edges(2 * m);
+		std::vector<std::int32_t> offsets(n + 1);
+		std::vector<std::int32_t> incident(header.incident_count);
+		std::vector<std::int32_t> boundaries(3 * header.boundary_count);
+		if (!binary_io::readArray(is, edges.data(), edges.size())
+			|| !binary_io::readArray(is, offsets.data(), offsets.size())
+			|| !binary_io::readArray(is, incident.data(), incident.size())
+			|| !binary_io::readArray(is, boundaries.data(), boundaries.size())) {
+			return false;
+		}
+
+		// validate all indices here, and the structure once the layout is complete
+		auto inRange = [](std::int32_t i, std::uint64_t count) {
+			return 0 <= i && i < count;
+		};
+		if (!std::ranges::all_of(edges, [&](std::int32_t v) { return inRange(v, n); })
+			|| !std::ranges::all_of(incident, [&](std::int32_t e) { return inRange(e, m); })
+			|| offsets[0] != 0 || offsets[n] != header.incident_count
+			|| !std::ranges::is_sorted(offsets)) {
+			return false;
+		}
+		for (int i = 0; i < header.boundary_count; i++) {
+			if (!inRange(boundaries[3 * i], m) || !inRange(boundaries[3 * i + 1], m)) {
+				return false;
+			}
+		}
+
+		std::vector<Number<K>> exact_xs, exact_ys;
+		std::vector<bool> has_exact_x(n, false), has_exact_y(n, false);
+		if (header.exact_count > 0) {
+			exact_xs.resize(n);
+			exact_ys.resize(n);
+		}
+		for (int i = 0; i < header.exact_count; i++) {
+			std::int32_t record[4];
+			std::string text;
+			if (!binary_io::read(is, record) || !inRange(record[0], n) || (record[1] != 0 && record[1] != 1) || record[2] < 0) {
+				return false;
+			}
+			text.resize(record[2]);
+			if (!binary_io::readArray(is, text.data(), text.size())) {
+				return false;
+			}
+			Number<K>& target = record[1] == 0 ? exact_xs[record[0]] : exact_ys[record[0]];
+			if (!binary_io::parseNumber<K>(text, target)) {
+				return false;
+			}
+			(record[1] == 0 ? has_exact_x : has_exact_y)[record[0]] = true;
+		}
+
+		layout.points.clear();
+		layout.points.reserve(n);
+		for (int i = 0; i < n; i++) {
+			layout.points.emplace_back(
+				has_exact_x[i] ? exact_xs[i] : Number<K>(xs[i]),
+				has_exact_y[i] ? exact_ys[i] : Number<K>(ys[i]));
+		}
+
+		layout.edges.resize(m);
+		for (int i = 0; i < m; i++) {
+			layout.edges[i] = { edges[2 * i], edges[2 * i + 1] };
+		}
+
+		layout.incident_offsets.assign(offsets.begin(), offsets.end());
+		layout.incident.assign(incident.begin(), incident.end());
+
+		layout.boundaries.resize(header.boundary_count);
+		for (int i = 0; i < header.boundary_count; i++) {
+			layout.boundaries[i] = { boundaries[3 * i], boundaries[3 * i + 1], boundaries[3 * i + 2] != 0 };
+		}
+
+		layout.oriented = (header.flags & SnapshotHeader::ORIENTED) != 0;
+		layout.sorted = (header.flags & SnapshotHeader::SORTED) != 0;
+
+		if (!detail::isConsistentLayout(layout)) {
+			layout = GraphLayout<K>();
+			return false;
+		}
+
+		return true;
+	}
+
+} // namespace cartocrow::simplification
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace cartocrow::simplification {
+
+	/// <summary>
+	/// Stable reference to a graph element. Unlike a pointer or graph index, a handle can be checked for validity:
+	/// once the element is removed from the graph, its handle no longer resolves, even if the slot has been reused.
+	/// </summary>
+	template <typename T> struct Handle {
+		int slot = -1;
+		std::uint32_t generation = 0;
+
+		bool operator==(const Handle& other) const = default;
+	};
+
+	namespace detail {
+
+		/// <summary>
+		/// Maps handle slots to elements. Slots of removed elements are recycled, with an increased generation to
+		/// invalidate outstanding handles. As slots are never moved implicitly, side tables indexed by slot remain
+		/// valid under graph mutations; compact() can be used to restore density.
+		/// </summary>
+		template <typename T> class HandleTable {
+		private:
+			struct Entry {
+				T* elt;
+				std::uint32_t generation;
+			};
+
+			std::vector<Entry> entries;
+			std::vector<int> free_slots;
+
+		public:
+			int acquire(T* elt) {
+				if (free_slots.empty()) {
+					entries.push_back({elt, 0});
+					return entries.size() - 1;
+				}
+				int slot = free_slots.back();
+				free_slots.pop_back();
+				entries[slot].elt = elt;
+				return slot;
+			}
+
+			void release(int slot) {
+				assert(entries[slot].elt != nullptr);
+				entries[slot].elt = nullptr;
+				entries[slot].generation++;
+				free_slots.push_back(slot);
+			}
+
+			/// <summary>
+			/// Points the slot to a new location of the same element, retaining outstanding handles.
+			/// </summary>
+			void relocate(int slot, T* elt) {
+				assert(entries[slot].elt != nullptr);
+				entries[slot].elt = elt;
+			}
+
+			Handle<T> handleOf(int slot) const {
+				return {slot, entries[slot].generation};
+			}
+
+			bool isValid(Handle<T> h) const {
+				return 0 <= h.slot && h.slot < entries.size() && entries[h.slot].elt != nullptr &&
+				       entries[h.slot].generation == h.generation;
+			}
+
+			T* resolve(Handle<T> h) const {
+				return isValid(h) ? entries[h.slot].elt : nullptr;
+			}
+
+			/// <summary>
+			/// Number of slots, including free ones; side tables indexed by slot should have this size.
+			/// </summary>
+			int slotCount() const {
+				return entries.size();
+			}
+
+			/// <summary>
+			/// Renumbers the slots of the live elements in the given order, which must contain exactly the live elements.
+			/// Returns the mapping from old to new slots, with -1 for free slots. All existing handles become invalid.
+			/// The caller is responsible for storing the new slot in each element.
+			/// </summary>
+			std::vector<int> compact(const std::vector<T*>& order, const std::vector<int>& old_slots) {
+				assert(order.size() == old_slots.size());
+
+				// start all slots at a generation beyond any issued so far, such that handles taken before
+				// compaction are not silently reinterpreted
+				std::uint32_t generation = 0;
+				for (const Entry& e : entries) {
+					generation = std::max(generation, e.generation + 1);
+				}
+
+				std::vector<int> remap(entries.size(), -1);
+				std::vector<Entry> compacted;
+				compacted.reserve(order.size());
+				for (int i = 0; i < order.size(); i++) {
+					assert(entries[old_slots[i]].elt == order[i]);
+					remap[old_slots[i]] = i;
+					compacted.push_back({order[i], generation});
+				}
+				entries = std::move(compacted);
+				free_slots.clear();
+				return remap;
+			}
+
+			void clear() {
+				entries.clear();
+				free_slots.clear();
+			}
+		};
+
+		/// <summary>
+		/// Applies a remapping returned by compaction to a side table indexed by slot.
+		/// </summary>
+		template <typename V> void remapSideTable(std::vector<V>& table, const std::vector<int>& remap, int new_size) {
+			std::vector<V> result(new_size);
+			for (int i = 0; i < remap.size() && i < table.size(); i++) {
+				if (remap[i] >= 0) {
+					result[remap[i]] = std::move(table[i]);
+				}
+			}
+			table = std::move(result);
+		}
+
+	} // namespace detail
+
+} // namespace cartocrow::simplification
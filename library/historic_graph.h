@@ -2,18 +2,78 @@
 
 #include <cartocrow/core/core.h>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#include "graph_layout.h"
+
 namespace cartocrow::simplification {
 
 	namespace detail {
-		template <class Graph> struct Operation;
-		template <class Graph> struct OperationBatch;
+		template <class Graph> struct EdgeIds;
+		template <class Graph> struct OperationLog;
+		template <typename K> struct BatchRecord;
+		template <class Graph> struct Checkpoint;
 
+		// edges store their identifier in the history, which operations use to refer to them
 		template <class Graph>
 		concept EdgeStoredOperations = requires(typename Graph::Edge::Data d) {
 
 			{
 				d.hist
-			} -> std::same_as<Operation<Graph>*&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
+			} -> std::same_as<int&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
+		};
+	}
+
+	/// <summary>
+	/// Receives the changes that recalling history makes to the graph, such that structures built on the graph can be
+	/// kept up to date without rebuilding them. The "before" calls are made while the affected elements still exist.
+	/// Operations performed while building batches are not reported, as their caller knows about them.
+	/// </summary>
+	template <class Graph> class HistoryObserver {
+	public:
+		using Vertex = Graph::Vertex;
+		using Edge = Graph::Edge;
+
+		virtual ~HistoryObserver() = default;
+
+		/// <summary>
+		/// The degree-2 vertex is about to be erased, merging its two edges.
+		/// </summary>
+		virtual void beforeMerge(Vertex* v) {}
+		/// <summary>
+		/// The edge resulting from the merge.
+		/// </summary>
+		virtual void afterMerge(Edge* e) {}
+		/// <summary>
+		/// The edge is about to be split.
+		/// </summary>
+		virtual void beforeSplit(Edge* e) {}
+		/// <summary>
+		/// The degree-2 vertex created by the split.
+		/// </summary>
+		virtual void afterSplit(Vertex* v) {}
+		virtual void beforeShift(Vertex* v) {}
+		virtual void afterShift(Vertex* v) {}
+		/// <summary>
+		/// All vertices and edges were replaced, as the graph was restored from a checkpoint or read from a stream.
+		/// Elements passed to later calls may therefore be unknown to the observer, until it rebuilds its structures.
+		/// </summary>
+		virtual void afterRebuild() {}
+	};
+
+	namespace detail {
+		struct NoHistoryObserver {};
+
+		// the observer interface for a graph type, which is empty if the graph has no history
+		template <class MG> struct HistoryObserverOf {
+			using type = NoHistoryObserver;
 		};
 	}
 
@@ -27,16 +87,35 @@ namespace cartocrow::simplification {
 		using BaseGraph = Graph;
 
 	private:
-		using Batch = detail::OperationBatch<Graph>;
+		using Batch = detail::BatchRecord<Kernel>;
+		using Checkpoint = detail::Checkpoint<Graph>;
 
 		Graph& graph;
+		detail::EdgeIds<Graph> ids;
+		HistoryObserver<Graph>* observer = nullptr;
 
 		Number<Kernel> max_cost;
+		// the input, to recognize histories that were recorded on it
 		int in_complexity;
-		Batch* building_batch = nullptr;
-
-		std::vector<Batch*> history;
-		std::vector<Batch*> undone;
+		int in_boundaries;
+		std::uint64_t in_fingerprint;
+		bool building = false;
+
+		// all operations in order, with per batch the end of its range in the log; the first applied batches
+		// form the current state, the others have been undone
+		detail::OperationLog<Graph> log;
+		std::vector<Batch> batches;
+		int applied = 0;
+
+		// snapshots of the graph after every checkpoint_interval batches, ordered by batch count
+		int checkpoint_interval = 0;
+		std::vector<Checkpoint*> checkpoints;
+
+		void takeCheckpoint();
+		// rebuilds the graph from the checkpoint, without applying or undoing any batches
+		void restoreCheckpoint(Checkpoint* cp);
+		// retakes all checkpoints by replaying the full timeline, returning to the current state afterwards
+		void rebuildCheckpoints();
 
 	public:
 		HistoricGraph(Graph& graph);
@@ -47,13 +126,92 @@ namespace cartocrow::simplification {
 		std::vector<Edge*>& getEdges();
 		int getEdgeCount();
 
+		/// <summary>
+		/// Recalls the first state with at most c edges, or the present if no such state exists.
+		/// </summary>
 		void recallComplexity(int c);
+		/// <summary>
+		/// Recalls the last state in which all performed batches have cost at most t.
+		/// </summary>
 		void recallThreshold(Number<Kernel> t);
+		/// <summary>
+		/// Recalls the state after the first count batches. If rebuilding the graph from a checkpoint and replaying the
+		/// remaining batches is estimated to be cheaper than replaying from the current state, by the number of logged
+		/// operations and edges involved, the checkpoint is used; this replaces all vertex and edge objects of the graph.
+		/// </summary>
+		void recallBatches(int count);
+
+		/// <summary>
+		/// Stores a checkpoint of the graph whenever the number of batches reaches a multiple of the interval, and
+		/// immediately if the current state lies at such a multiple. Recalling a state far from the current one then
+		/// replays at most about half the interval of batches after restoring a checkpoint, at the expense of memory
+		/// for the snapshots. Restoring costs time linear in the size of the graph, so intervals much shorter than
+		/// the number of edges only pay off for long jumps.
+		/// An interval of 0 (the default) disables checkpoints and discards the existing ones.
+		/// Checkpoints are only taken while building the history, so the interval should be set before running.
+		/// </summary>
+		void setCheckpointInterval(int batches);
+		int getCheckpointInterval();
+		int getCheckpointCount();
+
+		/// <summary>
+		/// The number of batches recalled by recallComplexity(c), found by binary search.
+		/// </summary>
+		int batchesForComplexity(int c);
+		/// <summary>
+		/// The number of batches recalled by recallThreshold(t), found by binary search.
+		/// </summary>
+		int batchesForThreshold(Number<Kernel> t);
+
+		/// <summary>
+		/// The number of batches that are currently applied.
+		/// </summary>
+		int getAppliedBatchCount();
+		/// <summary>
+		/// The number of batches in the full history, including undone ones.
+		/// </summary>
+		int getBatchCount();
+		/// <summary>
+		/// The number of edges before the first batch.
+		/// </summary>
+		int getInputComplexity();
+		/// <summary>
+		/// The number of operations in the full history.
+		/// </summary>
+		int getOperationCount();
+		/// <summary>
+		/// The number of bytes reserved for the history (operations and batches), excluding checkpoints.
+		/// </summary>
+		size_t getHistoryBytes();
+		/// <summary>
+		/// The maximum cost of the currently applied batches, or 0 if there are none.
+		/// </summary>
+		Number<Kernel> getMaxCost();
 		void backInTime();
 		void forwardInTime();
 		void goToPresent();
 		bool atPresent();
 
+		/// <summary>
+		/// Sets the observer that is informed of all changes made by recalling history, or nullptr for none.
+		/// </summary>
+		void setObserver(HistoryObserver<Graph>* obs);
+		HistoryObserver<Graph>* getObserver();
+
+		/// <summary>
+		/// Writes the current graph and the full history, including undone batches, to the (binary) stream. The stream
+		/// is written sequentially, and the checkpoints are not included.
+		/// </summary>
+		void write(std::ostream& os);
+		/// <summary>
+		/// Replaces the graph and its history by those written by write(), after which any state can be recalled
+		/// without running the algorithm that produced it. Checkpoints are retaken if enabled, which replays the history once.
+		/// Returns false, leaving the graph and history unchanged, if the stream does not contain a valid history, or
+		/// if the history was recorded on another input: its edge count, boundary count and vertex coordinates must
+		/// match those of the graph this object was constructed on.
+		/// </summary>
+		bool read(std::istream& is);
+
 		void startBatch(Number<Kernel> c);
 		void endBatch();
 
@@ -63,6 +221,12 @@ namespace cartocrow::simplification {
 		
 	};
 
+	namespace detail {
+		template <class Graph> struct HistoryObserverOf<HistoricGraph<Graph>> {
+			using type = HistoryObserver<Graph>;
+		};
+	}
+
 } // namespace cartocrow::simplification
 
 #include "historic_graph.hpp"
\ No newline at end of file
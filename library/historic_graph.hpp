@@ -3,226 +3,313 @@
 // Do not include this file, but the .h file instead
 // -----------------------------------------------------------------------------
 
+#include <cstring>
+#include <limits>
+
+#include "binary_io.h"
+#include "graph_snapshot.h"
+
 namespace cartocrow::simplification {
 
 	namespace detail {
-		template <class Graph> struct Operation {
+		constexpr char HISTORY_MAGIC[8] = { 'C', 'C', 'S', 'H', 'I', 'S', 'T', 'O' };
+		constexpr std::uint32_t HISTORY_VERSION = 2;
 
-			using Edge = Graph::Edge;
+		// Operations refer to edges by identifiers, rather than by pointers: undoing and redoing operations may replace
+		// the edge objects, and restoring a checkpoint replaces all of them. An edge that is recreated by undo or redo
+		// obtains the identifier it had before, such that later operations can still find it.
+		template <class Graph> struct EdgeIds {
 
-			Edge* edge;
+			using Edge = Graph::Edge;
 
-			Operation(Edge* e) : edge(e) {}
+			// the current edge for each identifier, or nullptr if it is not in the graph
+			std::vector<Edge*> edges;
 
-			virtual void undo(Graph& g) = 0;
-			virtual void redo(Graph& g) = 0;
-		};
+			Edge* get(int id) {
+				assert(edges[id] != nullptr);
+				return edges[id];
+			}
 
-		template <class Graph> struct SplitOperation : public Operation<Graph> {
+			int of(Edge* e) {
+				return e->data().hist;
+			}
 
-			using Edge = Graph::Edge;
-			using Vertex = Graph::Vertex;
-			using Op = Operation<Graph>;
+			// binds the edge to the identifier, or to a new identifier if it is -1; returns the identifier
+			int bind(Edge* e, int id) {
+				if (id < 0) {
+					id = edges.size();
+					edges.push_back(e);
+				}
+				else {
+					edges[id] = e;
+				}
+				e->data().hist = id;
+				return id;
+			}
 
-			SplitOperation(Edge* e, Point<typename Graph::Kernel> pt) : Operation<Graph>(e), loc(pt) {
-				// store the past
-				past = e->data().hist;
-				// we don't know the future yet
-				future_inc = nullptr;
-				future_out = nullptr;
+			void unbind(int id) {
+				edges[id] = nullptr;
 			}
+		};
 
-			// if not yet performed / undone:
-			//   edge == the edge to split
-			// if performed / redone:
-			//   edge == incoming edge of the created vertex
+		enum class OperationType : std::uint8_t {
+			ERASE,
+			SPLIT,
+			SHIFT
+		};
 
-			Point<typename Graph::Kernel> loc;
-			Op* past;
-			Op* future_inc;
-			Op* future_out;
+		// A single operation, as an entry of the contiguous operation log. Per type, the fields are:
+		//   ERASE: edges = (incoming, outgoing, merged), point = location of the erased vertex
+		//   SPLIT: edges = (split, incoming, outgoing), point = location of the created vertex
+		//   SHIFT: edges = (incoming, -, -), points point and point + 1 = location before and after the shift
+		// where incoming and outgoing refer to the edges of the erased, created or shifted vertex.
+		struct LoggedOperation {
+			OperationType type;
+			int edges[3];
+			int point;
+		};
 
-			virtual void undo(Graph& g) {
+		template <typename K> struct BatchRecord {
+			/// End of the operations of this batch in the log; they start at the end of the previous batch
+			int end;
+			/// Number of edges in the map after this batch
+			int post_complexity;
+			/// Maximum cost of operations up to this batch
+			Number<K> post_maxcost;
+		};
 
-				// store the future
-				future_inc = this->edge->data().hist;
-				future_out = this->edge->next()->data().hist;
+		// Points of the operation log. Kernels with double coordinates store them as plain pairs, others store the
+		// kernel points themselves, as these may not be representable by doubles.
+		template <typename K> struct PointLog {
+			static constexpr bool plain = std::is_same_v<Number<K>, double>;
+			using Stored = std::conditional_t<plain, std::array<double, 2>, Point<K>>;
 
-				// perform and update this edge
-				this->edge = g.mergeVertex(this->edge->getTarget());
+			std::vector<Stored> points;
 
-				// update the past
-				this->edge->data().hist = past;
-				if (past != nullptr) {
-					past->edge = this->edge;
+			int add(const Point<K>& pt) {
+				if constexpr (plain) {
+					points.push_back({ pt.x(), pt.y() });
 				}
+				else {
+					points.push_back(pt);
+				}
+				return points.size() - 1;
 			}
 
-			virtual void redo(Graph& g) {
-				perform(g);
-			}
-
-			Vertex* perform(Graph& g) {
-
-				// perform and update this edge
-				Vertex* v = g.splitEdge(this->edge, loc);
-				this->edge = v->incoming();
-
-				// update the future
-				v->incoming()->data().hist = future_inc;
-				v->outgoing()->data().hist = future_out;
-				if (future_inc != nullptr) {
-					future_inc->edge = v->incoming();
+			Point<K> get(int i) const {
+				if constexpr (plain) {
+					return Point<K>(points[i][0], points[i][1]);
 				}
-				if (future_out != nullptr) {
-					future_out->edge = v->outgoing();
+				else {
+					return points[i];
 				}
-
-				return v;
 			}
 		};
 
-		template <class Graph> struct EraseOperation : public Operation<Graph> {
+		template <class Graph> struct OperationLog {
 
 			using Edge = Graph::Edge;
 			using Vertex = Graph::Vertex;
-			using Op = Operation<Graph>;
-
-			EraseOperation(Vertex* v) : Operation<Graph>(v->incoming()), loc(v->getPoint()) {
-				// store the past
-				past_inc = v->incoming()->data().hist;
-				past_out = v->outgoing()->data().hist;
-				// we don't know the future yet
-				future = nullptr;
-			}
-
-			// if not yet performed / undone:
-			//   edge == incoming edge of the vertex to erase
-			// if performed / redone:
-			//   edge == the resulting edge
+			using Kernel = Graph::Kernel;
+			using Observer = HistoryObserver<Graph>;
 
-			Point<typename Graph::Kernel> loc;
-			Op* past_inc;
-			Op* past_out;
-			Op* future;
+			std::vector<LoggedOperation> operations;
+			PointLog<Kernel> points;
 
-			virtual void undo(Graph& g) {
-
-				// store the future
-				future = this->edge->data().hist;
-
-				// perform and update this edge
-				Vertex* v = g.splitEdge(this->edge, loc);
-				this->edge = v->incoming();
-
-				// update the past
-				v->incoming()->data().hist = past_inc;
-				v->outgoing()->data().hist = past_out;
-				if (past_inc != nullptr) {
-					past_inc->edge = this->edge;
+			// the graph operations, reported to the observer if any
+			static Edge* merge(Graph& g, Vertex* v, Observer* obs) {
+				if (obs != nullptr) {
+					obs->beforeMerge(v);
 				}
-				if (past_out != nullptr) {
-					past_out->edge = this->edge->next();
+				Edge* e = g.mergeVertex(v);
+				if (obs != nullptr) {
+					obs->afterMerge(e);
 				}
+				return e;
 			}
 
-			virtual void redo(Graph& g) {
-				perform(g);
+			static Vertex* split(Graph& g, Edge* e, const Point<Kernel>& pt, Observer* obs) {
+				if (obs != nullptr) {
+					obs->beforeSplit(e);
+				}
+				Vertex* v = g.splitEdge(e, pt);
+				if (obs != nullptr) {
+					obs->afterSplit(v);
+				}
+				return v;
 			}
 
-			Edge* perform(Graph& g) {
-
-				// perform and update this edge
-				this->edge = g.mergeVertex(this->edge->getTarget());
-
-				// update the future
-				this->edge->data().hist = future;
-				if (future != nullptr) {
-					future->edge = this->edge;
+			static void shift(Graph& g, Vertex* v, const Point<Kernel>& pt, Observer* obs) {
+				if (obs != nullptr) {
+					obs->beforeShift(v);
+				}
+				g.shiftVertex(v, pt);
+				if (obs != nullptr) {
+					obs->afterShift(v);
 				}
-
-				return this->edge;
 			}
-		};
 
-		template <class Graph> struct ShiftOperation : public Operation<Graph> {
-
-			using Edge = Graph::Edge;
-			using Vertex = Graph::Vertex;
-			using Op = Operation<Graph>;
-
-			ShiftOperation(Vertex* v, Point<typename Graph::Kernel> pt) : Operation<Graph>(v->incoming()), pre_loc(v->getPoint()), post_loc(pt) {
-				// store the past
-				past = this->edge->data().hist;
-				// we don't know the future yet
-				future = nullptr;
+			Edge* erase(Graph& g, EdgeIds<Graph>& ids, LoggedOperation& op, Observer* obs) {
+				Edge* e = merge(g, ids.get(op.edges[0])->getTarget(), obs);
+				ids.unbind(op.edges[0]);
+				ids.unbind(op.edges[1]);
+				op.edges[2] = ids.bind(e, op.edges[2]);
+				return e;
 			}
 
-			// edge is always the incoming edge of v
-			Op* past;
-			Op* future;
-
-			Point<typename Graph::Kernel> pre_loc;
-			Point<typename Graph::Kernel> post_loc;
-
-			virtual void undo(Graph& g) {
-
-				// store the future
-				future = this->edge->data().hist;
-
-				// perform (no need to update edge...)
-				this->edge->getTarget()->setPoint(pre_loc);
+			Vertex* split(Graph& g, EdgeIds<Graph>& ids, LoggedOperation& op, Observer* obs) {
+				Vertex* v = split(g, ids.get(op.edges[0]), points.get(op.point), obs);
+				ids.unbind(op.edges[0]);
+				op.edges[1] = ids.bind(v->incoming(), op.edges[1]);
+				op.edges[2] = ids.bind(v->outgoing(), op.edges[2]);
+				return v;
+			}
 
-				// update the past
-				this->edge->data().hist = past;
-				if (past != nullptr) {
-					past->edge = this->edge; // NB: we should keep doing this as the edge may have changed in the future
+			void undo(Graph& g, EdgeIds<Graph>& ids, const LoggedOperation& op, Observer* obs) {
+				switch (op.type) {
+				case OperationType::ERASE: {
+					Vertex* v = split(g, ids.get(op.edges[2]), points.get(op.point), obs);
+					ids.unbind(op.edges[2]);
+					ids.bind(v->incoming(), op.edges[0]);
+					ids.bind(v->outgoing(), op.edges[1]);
+					break;
+				}
+				case OperationType::SPLIT: {
+					Edge* e = merge(g, ids.get(op.edges[1])->getTarget(), obs);
+					ids.unbind(op.edges[1]);
+					ids.unbind(op.edges[2]);
+					ids.bind(e, op.edges[0]);
+					break;
+				}
+				case OperationType::SHIFT:
+					shift(g, ids.get(op.edges[0])->getTarget(), points.get(op.point), obs);
+					break;
 				}
 			}
 
-			virtual void redo(Graph& g) {
+			void redo(Graph& g, EdgeIds<Graph>& ids, LoggedOperation& op, Observer* obs) {
+				switch (op.type) {
+				case OperationType::ERASE:
+					erase(g, ids, op, obs);
+					break;
+				case OperationType::SPLIT:
+					split(g, ids, op, obs);
+					break;
+				case OperationType::SHIFT:
+					shift(g, ids.get(op.edges[0])->getTarget(), points.get(op.point + 1), obs);
+					break;
+				}
+			}
 
-				// perform (no need to update edge)
-				this->edge->getTarget()->setPoint(post_loc);
+			// undoes the operations in [begin, end), in reverse
+			void undo(Graph& g, EdgeIds<Graph>& ids, int begin, int end, Observer* obs) {
+				for (int i = end - 1; i >= begin; i--) {
+					undo(g, ids, operations[i], obs);
+				}
+			}
 
-				// update the future
-				this->edge->data().hist = future;
-				if (future != nullptr) {
-					future->edge = this->edge; // NB: we should keep doing this as the edge may have changed in the future
+			void redo(Graph& g, EdgeIds<Graph>& ids, int begin, int end, Observer* obs) {
+				for (int i = begin; i < end; i++) {
+					redo(g, ids, operations[i], obs);
 				}
 			}
 		};
 
-		template <class Graph> struct OperationBatch {
-
-			using Op = Operation<Graph>;
-
-			~OperationBatch() {
-				for (Op* op : operations) {
-					delete op;
+		// Replays the operations on the edge endpoints alone, to verify that every operation consumes edges that are in
+		// the graph and that have the expected shape, and produces edges that are not. The log is replayed backward
+		// from the state after the first `applied` operations, and then forward to its end, covering both directions
+		// of every operation. Assumes all identifiers are in range.
+		template <typename K>
+		bool isConsistentLog(const GraphLayout<K>& layout, const std::vector<std::int32_t>& edge_ids, int id_count,
+		                     const std::vector<LoggedOperation>& operations, int applied) {
+			// the endpoints of each identifier, or (-1, -1) if it is not in the graph
+			std::vector<std::pair<int, int>> ends(id_count, { -1, -1 });
+			std::vector<int> degree(layout.points.size());
+			for (int v = 0; v < layout.points.size(); v++) {
+				degree[v] = layout.incident_offsets[v + 1] - layout.incident_offsets[v];
+			}
+			for (int i = 0; i < edge_ids.size(); i++) {
+				if (ends[edge_ids[i]].first >= 0) {
+					return false;
 				}
+				ends[edge_ids[i]] = layout.edges[i];
 			}
 
-			std::vector<Op*> operations;
-
-			/// Number of edges in the map after this operation
-			int post_complexity;
-			/// Maximum cost of operations up to this one
-			Number<typename Graph::Kernel> post_maxcost;
-
-			void undo(Graph& g) {
-				// NB: reverse
-				for (auto it = operations.rbegin(); it != operations.rend(); it++) {
+			auto live = [&ends](int id) {
+				return ends[id].first >= 0;
+			};
+			// replaces the incoming and outgoing edge of a degree-2 vertex by a single edge
+			auto merge = [&](int in, int out, int merged) {
+				if (!live(in) || !live(out) || live(merged) || in == out || ends[in].second != ends[out].first
+					|| degree[ends[in].second] != 2) {
+					return false;
+				}
+				degree[ends[in].second] = 0;
+				ends[merged] = { ends[in].first, ends[out].second };
+				ends[in] = ends[out] = { -1, -1 };
+				return true;
+			};
+			// replaces an edge by the incoming and outgoing edge of a new degree-2 vertex
+			auto split = [&](int e, int in, int out) {
+				if (!live(e) || live(in) || live(out) || in == out) {
+					return false;
+				}
+				int v = degree.size();
+				degree.push_back(2);
+				ends[in] = { ends[e].first, v };
+				ends[out] = { v, ends[e].second };
+				ends[e] = { -1, -1 };
+				return true;
+			};
+			auto step = [&](const LoggedOperation& op, bool forward) {
+				const int* e = op.edges;
+				switch (op.type) {
+				case OperationType::ERASE:
+					return forward ? merge(e[0], e[1], e[2]) : split(e[2], e[0], e[1]);
+				case OperationType::SPLIT:
+					return forward ? split(e[0], e[1], e[2]) : merge(e[1], e[2], e[0]);
+				case OperationType::SHIFT:
+					return live(e[0]);
+				}
+				return false;
+			};
 
-					Op* op = *it;
-					op->undo(g);
+			for (int i = applied - 1; i >= 0; i--) {
+				if (!step(operations[i], false)) {
+					return false;
 				}
 			}
-			void redo(Graph& g) {
-				for (Op* op : operations) {
-					op->redo(g);
+			for (const LoggedOperation& op : operations) {
+				if (!step(op, true)) {
+					return false;
 				}
 			}
+			return true;
+		}
+
+		// FNV-1a hash of the vertex coordinates, rounded to doubles, in the order of the vertex list
+		template <class Graph> std::uint64_t coordinateFingerprint(Graph& graph) {
+			std::uint64_t hash = 14695981039346656037ull;
+			auto add = [&hash](double d) {
+				std::uint64_t bits;
+				std::memcpy(&bits, &d, sizeof(bits));
+				for (int i = 0; i < 8; i++) {
+					hash = (hash ^ ((bits >> (8 * i)) & 0xff)) * 1099511628211ull;
+				}
+			};
+			for (typename Graph::Vertex* v : graph.getVertices()) {
+				add(CGAL::to_double(v->getPoint().x()));
+				add(CGAL::to_double(v->getPoint().y()));
+			}
+			return hash;
+		}
+
+		template <class Graph> struct Checkpoint {
+			// number of batches applied in the stored state
+			int batches;
+			GraphLayout<typename Graph::Kernel> layout;
+			// identifier per edge, by index in the layout
+			std::vector<int> ids;
 		};
 
 	}
@@ -234,17 +321,19 @@ namespace cartocrow::simplification {
 		assert(graph.isOriented());
 
 		in_complexity = graph.getEdgeCount();
+		in_boundaries = graph.getBoundaryCount();
+		in_fingerprint = detail::coordinateFingerprint(graph);
+
+		for (Edge* e : graph.getEdges()) {
+			ids.bind(e, -1);
+		}
 	}
 
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
 	HistoricGraph<Graph>::~HistoricGraph() {
-		for (Batch* op : history) {
-			delete op;
-		}
-
-		for (Batch* op : undone) {
-			delete op;
+		for (Checkpoint* cp : checkpoints) {
+			delete cp;
 		}
 	}
 
@@ -275,58 +364,426 @@ namespace cartocrow::simplification {
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
 	void HistoricGraph<Graph>::recallComplexity(int c) {
+		recallBatches(batchesForComplexity(c));
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	void HistoricGraph<Graph>::recallThreshold(Number<Kernel> t) {
+		recallBatches(batchesForThreshold(t));
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	void HistoricGraph<Graph>::recallBatches(int count) {
+
+		assert(!building);
+		assert(0 <= count && count <= getBatchCount());
+
+		if (!checkpoints.empty()) {
+			// replaying costs about one unit per logged operation; restoring a checkpoint destroys the current graph
+			// and rebuilds the stored one, which costs about half a unit per edge of either
+			auto logPosition = [this](int b) { return b == 0 ? 0 : batches[b - 1].end; };
+			int target = logPosition(count);
+			long long cheapest = std::abs(target - logPosition(applied));
+			Checkpoint* best = nullptr;
+
+			// the candidates are the last checkpoint at or before count, and the one after it
+			auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), count,
+				[](int c, Checkpoint* cp) { return c < cp->batches; });
+			for (Checkpoint* cp : { it != checkpoints.begin() ? *(it - 1) : nullptr,
+			                        it != checkpoints.end() ? *it : nullptr }) {
+				if (cp == nullptr) {
+					continue;
+				}
+				long long cost = (graph.getEdgeCount() + (long long) cp->ids.size()) / 2 +
+				                 std::abs(target - logPosition(cp->batches));
+				if (cost < cheapest) {
+					best = cp;
+					cheapest = cost;
+				}
+			}
 
-		assert(building_batch == nullptr);
+			if (best != nullptr) {
+				restoreCheckpoint(best);
+			}
+		}
 
-		while ( // if history is a single element, check input complexity
-			(history.size() >= 1 && in_complexity <= c)
-			// if history is more than a single element, check the previous operation
-			|| (history.size() > 1 && history[history.size() - 2]->post_complexity <= c)) {
+		while (applied > count) {
 			backInTime();
 		}
-		while (!undone.empty() && graph.getEdgeCount() > c) {
+		while (applied < count) {
 			forwardInTime();
 		}
 	}
 
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
-	void HistoricGraph<Graph>::recallThreshold(Number<Kernel> t) {
+	void HistoricGraph<Graph>::setCheckpointInterval(int batches) {
+		assert(batches >= 0);
 
-		assert(building_batch == nullptr);
+		checkpoint_interval = batches;
+		if (batches == 0) {
+			for (Checkpoint* cp : checkpoints) {
+				delete cp;
+			}
+			checkpoints.clear();
+		}
+		else if (atPresent() && applied % batches == 0 &&
+		         (checkpoints.empty() || checkpoints.back()->batches < applied)) {
+			takeCheckpoint();
+		}
+	}
 
-		while (history.size() >= 1 && history.last()->post_maxcost > t) {
-			backInTime();
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	int HistoricGraph<Graph>::getCheckpointInterval() {
+		return checkpoint_interval;
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	int HistoricGraph<Graph>::getCheckpointCount() {
+		return checkpoints.size();
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	void HistoricGraph<Graph>::setObserver(HistoryObserver<Graph>* obs) {
+		observer = obs;
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	HistoryObserver<Graph>* HistoricGraph<Graph>::getObserver() {
+		return observer;
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	void HistoricGraph<Graph>::takeCheckpoint() {
+		Checkpoint* cp = new Checkpoint();
+		cp->batches = applied;
+		cp->layout = graph.exportLayout();
+		cp->ids.reserve(graph.getEdgeCount());
+		for (Edge* e : graph.getEdges()) {
+			cp->ids.push_back(ids.of(e));
+		}
+		checkpoints.push_back(cp);
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	void HistoricGraph<Graph>::restoreCheckpoint(Checkpoint* cp) {
+		graph.clear();
+		graph.importLayout(cp->layout);
+
+		std::fill(ids.edges.begin(), ids.edges.end(), nullptr);
+		std::vector<Edge*>& edges = graph.getEdges();
+		for (int i = 0; i < edges.size(); i++) {
+			ids.bind(edges[i], cp->ids[i]);
+		}
+
+		applied = cp->batches;
+
+		if (observer != nullptr) {
+			observer->afterRebuild();
 		}
-		while (!undone.empty() && undone.last()->post_maxcost <= t) {
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	void HistoricGraph<Graph>::rebuildCheckpoints() {
+		for (Checkpoint* cp : checkpoints) {
+			delete cp;
+		}
+		checkpoints.clear();
+
+		// the observer was told about the rebuild already, the replay is of no interest to it
+		HistoryObserver<Graph>* obs = observer;
+		observer = nullptr;
+
+		int count = applied;
+		recallBatches(0);
+		takeCheckpoint();
+		while (!atPresent()) {
 			forwardInTime();
+			if (applied % checkpoint_interval == 0) {
+				takeCheckpoint();
+			}
 		}
+		recallBatches(count);
+
+		observer = obs;
 	}
 
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
-	void HistoricGraph<Graph>::backInTime() {
+	void HistoricGraph<Graph>::write(std::ostream& os) {
+		assert(!building);
+
+		binary_io::writeArray(os, detail::HISTORY_MAGIC, 8);
+		binary_io::write<std::uint32_t>(os, detail::HISTORY_VERSION);
+		binary_io::write<std::int32_t>(os, in_complexity);
+		binary_io::write<std::int32_t>(os, in_boundaries);
+		binary_io::write<std::uint64_t>(os, in_fingerprint);
+		binary_io::write<std::int32_t>(os, applied);
+		binary_io::writeNumber<Kernel>(os, max_cost);
+
+		// the current state, with the identifier of each edge
+		writeSnapshot(os, graph.exportLayout());
+		std::vector<std::int32_t> edge_ids;
+		edge_ids.reserve(graph.getEdgeCount());
+		for (Edge* e : graph.getEdges()) {
+			edge_ids.push_back(ids.of(e));
+		}
+		binary_io::writeVector(os, edge_ids);
+		binary_io::write<std::uint64_t>(os, ids.edges.size());
+
+		binary_io::writeVector(os, log.operations);
+		binary_io::write<std::uint64_t>(os, log.points.points.size());
+		for (int i = 0; i < log.points.points.size(); i++) {
+			Point<Kernel> pt = log.points.get(i);
+			binary_io::writeNumber<Kernel>(os, pt.x());
+			binary_io::writeNumber<Kernel>(os, pt.y());
+		}
+
+		binary_io::write<std::uint64_t>(os, batches.size());
+		for (const Batch& b : batches) {
+			binary_io::write<std::int32_t>(os, b.end);
+			binary_io::write<std::int32_t>(os, b.post_complexity);
+			binary_io::writeNumber<Kernel>(os, b.post_maxcost);
+		}
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	bool HistoricGraph<Graph>::read(std::istream& is) {
+		assert(!building);
+
+		constexpr std::uint64_t max_count = std::numeric_limits<std::int32_t>::max();
+
+		char magic[8];
+		std::uint32_t version;
+		std::int32_t complexity;
+		std::int32_t boundary_count;
+		std::uint64_t fingerprint;
+		std::int32_t count;
+		Number<Kernel> cost;
+		if (!binary_io::readArray(is, magic, 8) || std::memcmp(magic, detail::HISTORY_MAGIC, 8) != 0
+			|| !binary_io::read(is, version) || version != detail::HISTORY_VERSION
+			|| !binary_io::read(is, complexity) || !binary_io::read(is, boundary_count)
+			|| !binary_io::read(is, fingerprint) || !binary_io::read(is, count)
+			|| !binary_io::readNumber<Kernel>(is, cost)) {
+			return false;
+		}
+		// the history must start from the same input, as callers may hold on to its vertices or boundaries by index
+		if (complexity != in_complexity || boundary_count != in_boundaries || fingerprint != in_fingerprint) {
+			return false;
+		}
+
+		GraphLayout<Kernel> layout;
+		std::vector<std::int32_t> edge_ids;
+		std::uint64_t id_count;
+		if (!readSnapshot(is, layout) || !layout.oriented
+			|| !binary_io::readVector(is, edge_ids, max_count) || edge_ids.size() != layout.edges.size()
+			|| !binary_io::read(is, id_count) || id_count > max_count) {
+			return false;
+		}
+
+		detail::OperationLog<Graph> read_log;
+		std::uint64_t point_count;
+		if (!binary_io::readVector(is, read_log.operations, max_count)
+			|| !binary_io::read(is, point_count) || point_count > max_count) {
+			return false;
+		}
+		read_log.points.points.reserve(point_count);
+		for (std::uint64_t i = 0; i < point_count; i++) {
+			Number<Kernel> x, y;
+			if (!binary_io::readNumber<Kernel>(is, x) || !binary_io::readNumber<Kernel>(is, y)) {
+				return false;
+			}
+			read_log.points.add(Point<Kernel>(x, y));
+		}
+
+		std::uint64_t batch_count;
+		if (!binary_io::read(is, batch_count) || batch_count > max_count) {
+			return false;
+		}
+		std::vector<Batch> read_batches(batch_count);
+		for (Batch& b : read_batches) {
+			if (!binary_io::read(is, b.end) || !binary_io::read(is, b.post_complexity)
+				|| !binary_io::readNumber<Kernel>(is, b.post_maxcost)) {
+				return false;
+			}
+		}
+
+		// validate all indices, such that recalling needs no further checks
+		auto inRange = [](int i, std::uint64_t count) {
+			return 0 <= i && i < count;
+		};
+		for (std::int32_t id : edge_ids) {
+			if (!inRange(id, id_count)) {
+				return false;
+			}
+		}
+		for (const detail::LoggedOperation& op : read_log.operations) {
+			bool valid;
+			switch (op.type) {
+			case detail::OperationType::ERASE:
+			case detail::OperationType::SPLIT:
+				valid = inRange(op.edges[0], id_count) && inRange(op.edges[1], id_count) && inRange(op.edges[2], id_count)
+					&& inRange(op.point, point_count);
+				break;
+			case detail::OperationType::SHIFT:
+				valid = inRange(op.edges[0], id_count) && inRange(op.point + 1, point_count);
+				break;
+			default:
+				valid = false;
+			}
+			if (!valid) {
+				return false;
+			}
+		}
+		for (int i = 0; i < batch_count; i++) {
+			int begin = i == 0 ? 0 : read_batches[i - 1].end;
+			if (read_batches[i].end < begin || read_batches[i].end > read_log.operations.size()) {
+				return false;
+			}
+		}
+		if (count < 0 || count > batch_count
+			|| (batch_count > 0 && read_batches.back().end != read_log.operations.size())) {
+			return false;
+		}
+		// recalling any batch must find the edges its operations refer to
+		int applied_end = count == 0 ? 0 : read_batches[count - 1].end;
+		if (!detail::isConsistentLog(layout, edge_ids, id_count, read_log.operations, applied_end)) {
+			return false;
+		}
+
+		for (Checkpoint* cp : checkpoints) {
+			delete cp;
+		}
+		checkpoints.clear();
+
+		graph.clear();
+		graph.importLayout(layout);
+		ids.edges.assign(id_count, nullptr);
+		std::vector<Edge*>& edges = graph.getEdges();
+		for (int i = 0; i < edges.size(); i++) {
+			ids.bind(edges[i], edge_ids[i]);
+		}
 
-		assert(building_batch == nullptr);
+		max_cost = cost;
+		log = std::move(read_log);
+		batches = std::move(read_batches);
+		applied = count;
 
-		Batch* batch = history.back();
-		history.pop_back();
-		undone.push_back(batch);
+		if (observer != nullptr) {
+			observer->afterRebuild();
+		}
+		if (checkpoint_interval > 0) {
+			rebuildCheckpoints();
+		}
+		return true;
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	int HistoricGraph<Graph>::batchesForComplexity(int c) {
+		if (in_complexity <= c) {
+			return 0;
+		}
 
-		batch->undo(graph);
+		// complexities do not increase over the timeline: find the first batch reaching c
+		int lo = 0;
+		int hi = getBatchCount();
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (batches[mid].post_complexity <= c) {
+				hi = mid;
+			}
+			else {
+				lo = mid + 1;
+			}
+		}
+		return lo == getBatchCount() ? lo : lo + 1;
 	}
 
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
-	void HistoricGraph<Graph>::forwardInTime() {
+	int HistoricGraph<Graph>::batchesForThreshold(Number<Kernel> t) {
+		// maximum costs do not decrease over the timeline: count the batches within the threshold
+		int lo = 0;
+		int hi = getBatchCount();
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (batches[mid].post_maxcost > t) {
+				hi = mid;
+			}
+			else {
+				lo = mid + 1;
+			}
+		}
+		return lo;
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	int HistoricGraph<Graph>::getAppliedBatchCount() {
+		return applied;
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	int HistoricGraph<Graph>::getBatchCount() {
+		return batches.size();
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	int HistoricGraph<Graph>::getInputComplexity() {
+		return in_complexity;
+	}
 
-		assert(building_batch == nullptr);
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	int HistoricGraph<Graph>::getOperationCount() {
+		return log.operations.size();
+	}
 
-		Batch* batch = undone.back();
-		undone.pop_back();
-		history.push_back(batch);
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	size_t HistoricGraph<Graph>::getHistoryBytes() {
+		return log.operations.capacity() * sizeof(detail::LoggedOperation) +
+		       log.points.points.capacity() * sizeof(typename detail::PointLog<Kernel>::Stored) +
+		       batches.capacity() * sizeof(Batch);
+	}
 
-		batch->redo(graph);
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	Number<typename Graph::Kernel> HistoricGraph<Graph>::getMaxCost() {
+		return applied == 0 ? Number<Kernel>(0) : batches[applied - 1].post_maxcost;
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	void HistoricGraph<Graph>::backInTime() {
+
+		assert(!building);
+
+		applied--;
+		log.undo(graph, ids, applied == 0 ? 0 : batches[applied - 1].end, batches[applied].end, observer);
+	}
+
+	template <class Graph>
+		requires detail::EdgeStoredOperations<Graph>
+	void HistoricGraph<Graph>::forwardInTime() {
+
+		assert(!building);
+
+		log.redo(graph, ids, applied == 0 ? 0 : batches[applied - 1].end, batches[applied].end, observer);
+		applied++;
 	}
 
 	template <class Graph>
@@ -340,43 +797,46 @@ namespace cartocrow::simplification {
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
 	bool HistoricGraph<Graph>::atPresent() {
-		return undone.empty();
+		return applied == batches.size();
 	}
 
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
 	void HistoricGraph<Graph>::startBatch(Number<Kernel> c) {
-		assert(building_batch == nullptr);
+		assert(!building);
 		assert(atPresent());
 
-		building_batch = new Batch();
-		history.push_back(building_batch);
-
 		if (max_cost < c) {
 			max_cost = c;
 		}
 
-		building_batch->post_maxcost = max_cost;
+		building = true;
+		batches.push_back({ (int) log.operations.size(), 0, max_cost });
+		applied++;
 	}
 
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
 	void HistoricGraph<Graph>::endBatch() {
-		assert(building_batch != nullptr);
+		assert(building);
+
+		batches.back().end = log.operations.size();
+		batches.back().post_complexity = graph.getEdgeCount();
+		building = false;
 
-		building_batch->post_complexity = graph.getEdgeCount();
-		building_batch = nullptr;
+		if (checkpoint_interval > 0 && applied % checkpoint_interval == 0) {
+			takeCheckpoint();
+		}
 	}
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
 	Graph::Edge* HistoricGraph<Graph>::mergeVertex(Vertex* v) {
 		assert(v->degree() == 2);
-		assert(building_batch != nullptr);
+		assert(building);
 
-		detail::EraseOperation<Graph>* op = new detail::EraseOperation<Graph>(v);
-		Edge* e = op->perform(graph);
-		op->edge->data().hist = op;
-		building_batch->operations.push_back(op);
+		detail::LoggedOperation op{ detail::OperationType::ERASE, { ids.of(v->incoming()), ids.of(v->outgoing()), -1 }, log.points.add(v->getPoint()) };
+		Edge* e = log.erase(graph, ids, op, nullptr);
+		log.operations.push_back(op);
 
 		return e;
 	}
@@ -384,11 +844,11 @@ namespace cartocrow::simplification {
 	template <class Graph>
 		requires detail::EdgeStoredOperations<Graph>
 	Graph::Vertex* HistoricGraph<Graph>::splitEdge(Edge* e, Point<Kernel> p) {
+		assert(building);
 
-		detail::SplitOperation<Graph>* op = new detail::SplitOperation<Graph>(e, p);
-		Vertex* v = op->perform(graph);
-		op->edge->data().hist = op;
-		building_batch->operations.push_back(op);
+		detail::LoggedOperation op{ detail::OperationType::SPLIT, { ids.of(e), -1, -1 }, log.points.add(p) };
+		Vertex* v = log.split(graph, ids, op, nullptr);
+		log.operations.push_back(op);
 
 		return v;
 	}
@@ -398,12 +858,12 @@ namespace cartocrow::simplification {
 	void HistoricGraph<Graph>::shiftVertex(Vertex* v, Point<Kernel> p) {
 
 		assert(v->degree() > 0);
-		assert(building_batch != nullptr);
+		assert(building);
 
-		detail::ShiftOperation<Graph>* op = new detail::ShiftOperation<Graph>(v, p);
-		op->redo(graph);
-		op->edge->data().hist = op;
-		building_batch->operations.push_back(op);
+		detail::LoggedOperation op{ detail::OperationType::SHIFT, { ids.of(v->incoming()), -1, -1 }, log.points.add(v->getPoint()) };
+		log.points.add(p);
+		log.redo(graph, ids, op, nullptr);
+		log.operations.push_back(op);
 	}
 
-} // namespace cartocrow::simplification
\ No newline at end of file
+} // namespace cartocrow::simplification
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace cartocrow::simplification::detail {
+
+	/// <summary>
+	/// Binary min-heap of element pointers, in which each element stores its own position (via the traits), such that
+	/// it can be updated or removed in logarithmic time. Offers the interface of IndexedPriorityQueue, extended with
+	/// build(), which replaces the contents in linear time.
+	/// </summary>
+	/// <typeparam name="QT">Queue traits, providing Element, setIndex, getIndex and compare; see GraphQueueTraits</typeparam>
+	template <class QT> class IndexedHeap {
+	public:
+		using Element = QT::Element;
+
+	private:
+		std::vector<Element*> heap;
+
+		void place(Element* elt, int i) {
+			heap[i] = elt;
+			QT::setIndex(elt, i);
+		}
+
+		void siftUp(int i) {
+			Element* elt = heap[i];
+			while (i > 0) {
+				int parent = (i - 1) / 2;
+				if (QT::compare(elt, heap[parent]) >= 0) {
+					break;
+				}
+				place(heap[parent], i);
+				i = parent;
+			}
+			place(elt, i);
+		}
+
+		void siftDown(int i) {
+			Element* elt = heap[i];
+			int n = heap.size();
+			while (true) {
+				int child = 2 * i + 1;
+				if (child >= n) {
+					break;
+				}
+				if (child + 1 < n && QT::compare(heap[child + 1], heap[child]) < 0) {
+					child++;
+				}
+				if (QT::compare(heap[child], elt) >= 0) {
+					break;
+				}
+				place(heap[child], i);
+				i = child;
+			}
+			place(elt, i);
+		}
+
+		void erase(int i) {
+			QT::setIndex(heap[i], -1);
+			Element* last = heap.back();
+			heap.pop_back();
+			if (i < heap.size()) {
+				place(last, i);
+				update(last);
+			}
+		}
+
+	public:
+		bool empty() const {
+			return heap.empty();
+		}
+
+		int size() const {
+			return heap.size();
+		}
+
+		bool contains(Element* elt) const {
+			int i = QT::getIndex(elt);
+			return 0 <= i && i < heap.size() && heap[i] == elt;
+		}
+
+		Element* peek() const {
+			assert(!heap.empty());
+			return heap[0];
+		}
+
+		void push(Element* elt) {
+			heap.push_back(elt);
+			siftUp(heap.size() - 1);
+		}
+
+		Element* pop() {
+			Element* top = peek();
+			erase(0);
+			return top;
+		}
+
+		void remove(Element* elt) {
+			if (contains(elt)) {
+				erase(QT::getIndex(elt));
+			}
+		}
+
+		/// <summary>
+		/// Restores the heap order after the key of the (queued) element changed.
+		/// </summary>
+		void update(Element* elt) {
+			int i = QT::getIndex(elt);
+			if (i > 0 && QT::compare(elt, heap[(i - 1) / 2]) < 0) {
+				siftUp(i);
+			}
+			else {
+				siftDown(i);
+			}
+		}
+
+		/// <summary>
+		/// Collects the (at most) count smallest elements in order, without modifying the heap, by a best-first
+		/// traversal from the root that takes O(count log count) time. Among equal elements, the order may differ
+		/// from that in which pop() would return them.
+		/// </summary>
+		void peekSmallest(int count, std::vector<Element*>& out) const {
+			out.clear();
+			if (heap.empty()) {
+				return;
+			}
+
+			auto later = [this](int a, int b) { return QT::compare(heap[a], heap[b]) > 0; };
+			std::vector<int> frontier = { 0 };
+			while (!frontier.empty() && out.size() < count) {
+				std::pop_heap(frontier.begin(), frontier.end(), later);
+				int i = frontier.back();
+				frontier.pop_back();
+				out.push_back(heap[i]);
+
+				for (int child = 2 * i + 1; child <= 2 * i + 2 && child < heap.size(); child++) {
+					frontier.push_back(child);
+					std::push_heap(frontier.begin(), frontier.end(), later);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Empties the heap without accessing the elements, which may no longer exist (e.g. after recalling history);
+		/// contains() also rejects elements with stale indices, as it checks their position.
+		/// </summary>
+		void clear() {
+			heap.clear();
+		}
+
+		/// <summary>
+		/// Replaces the contents of the heap by the given elements, using a bottom-up heap construction that takes
+		/// linear time instead of the O(n log n) of pushing them one by one. The elements must be distinct.
+		/// </summary>
+		void build(std::vector<Element*>&& elements) {
+			clear();
+			heap = std::move(elements);
+			for (int i = 0; i < heap.size(); i++) {
+				QT::setIndex(heap[i], i);
+			}
+			for (int i = heap.size() / 2 - 1; i >= 0; i--) {
+				siftDown(i);
+			}
+		}
+	};
+
+} // namespace cartocrow::simplification::detail
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace cartocrow::simplification::detail {
+
+	/// <summary>
+	/// Allocator for objects of a single type, that hands out slots from fixed-size slabs.
+	/// Released slots are kept on a free list and reused by subsequent allocations, such that
+	/// repeated split/merge cycles do not hit the global allocator. Once all objects have been released,
+	/// the pool hands out its slots in order again, so that a structure rebuilt in an emptied pool is laid
+	/// out as compactly as a new one. Destroying the pool releases the memory one slab at a time; it does
+	/// not run the destructors of objects still alive.
+	/// </summary>
+	/// <typeparam name="T">The type of object to allocate</typeparam>
+	/// <typeparam name="SlabSize">The number of objects per slab</typeparam>
+	template <typename T, int SlabSize = 1024>
+	class SlabPool {
+	private:
+		union Slot {
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		std::vector<std::unique_ptr<Slot[]>> slabs;
+		Slot* free_list = nullptr;
+		// the slab from which unused slots are handed out, and the number of its slots that are in use;
+		// slabs after it have no slots in use
+		int slab_current = -1;
+		int slab_used = SlabSize;
+		int live = 0;
+
+		Slot* acquire() {
+			if (free_list != nullptr) {
+				Slot* s = free_list;
+				free_list = s->next;
+				return s;
+			}
+
+			if (slab_used == SlabSize) {
+				slab_current++;
+				if (slab_current == slabs.size()) {
+					slabs.push_back(std::make_unique<Slot[]>(SlabSize));
+				}
+				slab_used = 0;
+			}
+
+			return &slabs[slab_current][slab_used++];
+		}
+
+	public:
+		SlabPool() = default;
+		SlabPool(const SlabPool&) = delete;
+		SlabPool& operator=(const SlabPool&) = delete;
+		SlabPool(SlabPool&& other) noexcept {
+			*this = std::move(other);
+		}
+
+		/// <summary>
+		/// Takes over the slabs of the other pool, which is left empty. Objects in the slabs of this pool must have been
+		/// destructed by the caller (if needed).
+		/// </summary>
+		SlabPool& operator=(SlabPool&& other) noexcept {
+			if (this != &other) {
+				slabs = std::move(other.slabs);
+				free_list = other.free_list;
+				slab_current = other.slab_current;
+				slab_used = other.slab_used;
+				live = other.live;
+				other.clear();
+			}
+			return *this;
+		}
+
+		template <typename... Args>
+		T* create(Args&&... args) {
+			Slot* s = acquire();
+			T* obj = new (s->storage) T(std::forward<Args>(args)...);
+			live++;
+			return obj;
+		}
+
+		void destroy(T* obj) {
+			obj->~T();
+			Slot* s = reinterpret_cast<Slot*>(obj);
+			s->next = free_list;
+			free_list = s;
+			live--;
+
+			// the free list threads through the slabs in the order of release, start over from the first slab
+			if (live == 0) {
+				free_list = nullptr;
+				slab_current = 0;
+				slab_used = 0;
+			}
+		}
+
+		/// <summary>
+		/// Releases all memory at once. Any remaining objects must have been destructed by the caller (if needed).
+		/// </summary>
+		void clear() {
+			slabs.clear();
+			free_list = nullptr;
+			slab_current = -1;
+			slab_used = SlabSize;
+			live = 0;
+		}
+
+		int size() const {
+			return live;
+		}
+
+		int slabCount() const {
+			return slabs.size();
+		}
+
+		/// <summary>
+		/// Number of bytes reserved by the slabs of this pool.
+		/// </summary>
+		size_t reservedBytes() const {
+			return slabs.size() * SlabSize * sizeof(Slot);
+		}
+	};
+
+} // namespace cartocrow::simplification::detail
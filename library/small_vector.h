@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+namespace cartocrow::simplification::detail {
+
+	/// <summary>
+	/// Vector that stores up to N elements inline, and only moves its elements to the heap when it grows beyond that.
+	/// Intended for short lists of trivially copyable values, such as the incident edges of a vertex.
+	/// </summary>
+	/// <typeparam name="T">Element type, must be trivially copyable</typeparam>
+	/// <typeparam name="N">Inline capacity</typeparam>
+	template <typename T, int N>
+	class SmallVector {
+		static_assert(std::is_trivially_copyable_v<T>, "SmallVector only supports trivially copyable elements");
+
+	private:
+		union {
+			T inline_elts[N];
+			T* heap_elts;
+		};
+		int count = 0;
+		int capacity = N;
+
+		bool onHeap() const {
+			return capacity > N;
+		}
+
+		void grow(int mincap) {
+			int newcap = std::max(mincap, 2 * capacity);
+			T* elts = new T[newcap];
+			std::copy(begin(), end(), elts);
+			if (onHeap()) {
+				delete[] heap_elts;
+			}
+			heap_elts = elts;
+			capacity = newcap;
+		}
+
+	public:
+		using value_type = T;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		SmallVector() {}
+
+		SmallVector(const SmallVector& other) {
+			*this = other;
+		}
+
+		SmallVector(SmallVector&& other) {
+			*this = std::move(other);
+		}
+
+		SmallVector& operator=(const SmallVector& other) {
+			if (this != &other) {
+				clear();
+				reserve(other.count);
+				std::copy(other.begin(), other.end(), begin());
+				count = other.count;
+			}
+			return *this;
+		}
+
+		SmallVector& operator=(SmallVector&& other) {
+			if (this != &other) {
+				if (!other.onHeap()) {
+					*this = other;
+				}
+				else {
+					if (onHeap()) {
+						delete[] heap_elts;
+					}
+					heap_elts = other.heap_elts;
+					count = other.count;
+					capacity = other.capacity;
+					other.capacity = N;
+				}
+				other.count = 0;
+			}
+			return *this;
+		}
+
+		~SmallVector() {
+			if (onHeap()) {
+				delete[] heap_elts;
+			}
+		}
+
+		T* data() {
+			return onHeap() ? heap_elts : inline_elts;
+		}
+		const T* data() const {
+			return onHeap() ? heap_elts : inline_elts;
+		}
+
+		iterator begin() {
+			return data();
+		}
+		iterator end() {
+			return data() + count;
+		}
+		const_iterator begin() const {
+			return data();
+		}
+		const_iterator end() const {
+			return data() + count;
+		}
+
+		int size() const {
+			return count;
+		}
+		bool empty() const {
+			return count == 0;
+		}
+
+		T& operator[](int i) {
+			assert(0 <= i && i < count);
+			return data()[i];
+		}
+		const T& operator[](int i) const {
+			assert(0 <= i && i < count);
+			return data()[i];
+		}
+
+		T& front() {
+			return (*this)[0];
+		}
+		T& back() {
+			return (*this)[count - 1];
+		}
+
+		void reserve(int cap) {
+			if (cap > capacity) {
+				grow(cap);
+			}
+		}
+
+		void push_back(const T& elt) {
+			if (count == capacity) {
+				T copy = elt; // elt may refer into this vector
+				grow(count + 1);
+				data()[count++] = copy;
+			}
+			else {
+				data()[count++] = elt;
+			}
+		}
+
+		void pop_back() {
+			assert(count > 0);
+			count--;
+		}
+
+		iterator erase(iterator pos) {
+			std::copy(pos + 1, end(), pos);
+			count--;
+			return pos;
+		}
+
+		/// <summary>
+		/// Removes all elements; memory on the heap is retained.
+		/// </summary>
+		void clear() {
+			count = 0;
+		}
+	};
+
+} // namespace cartocrow::simplification::detail
@@ -2,6 +2,13 @@
 
 #include <cartocrow/core/core.h>
 
+#include <limits>
+
+#include "graph_layout.h"
+#include "handle_table.h"
+#include "slab_pool.h"
+#include "small_vector.h"
+
 namespace cartocrow::simplification {
 
 	template <class VD, class ED, typename K> class StraightVertex;
@@ -13,13 +20,17 @@ namespace cartocrow::simplification {
 		template <class VD, class ED, typename K> friend class StraightVertex;
 		template <class VD, class ED, typename K> friend class StraightEdge;
 		template <class VD, class ED, typename K> friend class StraightBoundary;
+		template <class VD2, class ED2, typename K2> friend class StraightGraph;
 		template <class InputGraph, class OutputGraph> friend OutputGraph* copy(InputGraph* input);
+		template <class InputGraph, class OutputGraph> friend OutputGraph* transfer(InputGraph*& input);
 
 	public:
 		using Kernel = K;
 		using Vertex = StraightVertex<VD, ED, K>;
 		using Edge = StraightEdge<VD, ED, K>;
 		using Boundary = StraightBoundary<VD, ED, K>;
+		using VertexHandle = Handle<Vertex>;
+		using EdgeHandle = Handle<Edge>;
 
 	private:
 		std::vector<Vertex*> vertices;
@@ -28,11 +39,43 @@ namespace cartocrow::simplification {
 		bool oriented;
 		bool sorted;
 
+		// vertices, edges and boundaries live in slabs, recycled via free lists
+		detail::SlabPool<Vertex> vertex_pool;
+		detail::SlabPool<Edge> edge_pool;
+		detail::SlabPool<Boundary> boundary_pool;
+
+		// stable handles for vertices and edges, unaffected by the swap-removal of the above lists
+		detail::HandleTable<Vertex> vertex_handles;
+		detail::HandleTable<Edge> edge_handles;
+
+		Vertex* createVertex(Point<K>& pt);
+		Vertex* createVertex(Point<K>&& pt);
+		void destroyVertex(Vertex* v);
+		Edge* createEdge(Vertex* source, Vertex* target);
+		void destroyEdge(Edge* e);
+		Boundary* createBoundary();
+		void destroyBoundary(Boundary* b);
+
+		// number of threads used by orient() and sortIncidentEdges()
+		int thread_count;
+
 		bool verifyOriented();
 		bool verifySorted();
 
 		void clearBoundaries();
 		void orientWithoutBoundaries();
+		void orientAt(Vertex* v);
+
+		// groups the degree-2 vertices into maximal chains, listed in order of graph index: chain c consists of members[offsets[c]..offsets[c+1])
+		void labelChains(std::vector<int>& offsets, std::vector<Vertex*>& members);
+		void orientChains(std::vector<int>& offsets, std::vector<Vertex*>& members);
+		void buildBoundaries(std::vector<int>& offsets, std::vector<Vertex*>& members);
+
+		// fills this empty graph with the structure of the input graph, moving in the given (converted) vertex locations
+		template <class InputGraph> void copyStructure(InputGraph* input, std::vector<Point<K>>&& points);
+
+		// moves all vertices and edges to fresh slabs, in the order of their graph index
+		void relocateElements();
 
 	public:
 		StraightGraph();
@@ -47,11 +90,90 @@ namespace cartocrow::simplification {
 		std::vector<Edge*>& getEdges();
 		std::vector<Boundary*>& getBoundaries();
 
+		/// <summary>
+		/// Number of bytes reserved for storing the vertices, edges and boundaries.
+		/// </summary>
+		size_t getReservedBytes();
+
+		/// <summary>
+		/// Sets the number of threads used to orient the graph and sort incident edges. The result does not depend on this number.
+		/// </summary>
+		void setThreadCount(int threads);
+		int getThreadCount();
+
+		VertexHandle getHandle(Vertex* v);
+		EdgeHandle getHandle(Edge* e);
+		/// <summary>
+		/// Returns the element referred to by the handle, or nullptr if it has been removed from the graph.
+		/// </summary>
+		Vertex* resolve(VertexHandle h);
+		Edge* resolve(EdgeHandle h);
+		bool isValid(VertexHandle h);
+		bool isValid(EdgeHandle h);
+
+		/// <summary>
+		/// Upper bound on handleSlot() of the vertices, to size side tables indexed by slot.
+		/// </summary>
+		int getVertexSlotCount();
+		/// <summary>
+		/// Upper bound on handleSlot() of the edges, to size side tables indexed by slot.
+		/// </summary>
+		int getEdgeSlotCount();
+		/// <summary>
+		/// Renumbers the vertex slots to match graphIndex(), invalidating all vertex handles.
+		/// Returns the mapping from old to new slots, which can be passed to detail::remapSideTable.
+		/// </summary>
+		std::vector<int> compactVertexHandles();
+		/// <summary>
+		/// Renumbers the edge slots to match graphIndex(), invalidating all edge handles.
+		/// Returns the mapping from old to new slots, which can be passed to detail::remapSideTable.
+		/// </summary>
+		std::vector<int> compactEdgeHandles();
+
 		Vertex* addVertex(Point<K> pt);
 		void removeVertex(Vertex* vtx);
 		Edge* addEdge(Vertex* source, Vertex* target);
 		void removeEdge(Edge* edge);
 
+		/// <summary>
+		/// Reserves room for the given total number of vertices and edges, to avoid reallocation while adding them one by one.
+		/// </summary>
+		void reserve(int vertex_count, int edge_count);
+
+		/// <summary>
+		/// Adds edges between existing vertices in one pass, each given as a pair of graph indices (source, target).
+		/// Self-loops and edges between vertices that are already neighbors are skipped.
+		/// </summary>
+		void addEdges(const std::vector<std::pair<int, int>>& pairs);
+
+		/// <summary>
+		/// Constructs the graph in one pass from a list of points and a list of edges, given as pairs of indices into the points.
+		/// The vertices obtain the indices of their points. The graph must be empty; it is oriented and sorted afterwards.
+		/// </summary>
+		void build(const std::vector<Point<K>>& points, const std::vector<std::pair<int, int>>& pairs);
+
+		/// <summary>
+		/// Renumbers the vertices along a Hilbert curve, and the edges by their lowest-numbered endpoint, such that
+		/// spatially close elements are close in the vertex and edge lists. Handles and boundaries are unaffected.
+		/// If relocate is set, the elements are also moved in memory to match their new order; this invalidates
+		/// all pointers to vertices and edges, so it may only be used when nothing outside the graph holds these.
+		/// </summary>
+		void reorderSpatially(bool relocate = false);
+
+		/// <summary>
+		/// Describes the graph by indices, such that it can be stored and rebuilt exactly with importLayout.
+		/// </summary>
+		GraphLayout<K> exportLayout();
+		/// <summary>
+		/// Constructs the graph as described by the layout, without recomputing orientation, sorting or boundaries.
+		/// The graph must be empty.
+		/// </summary>
+		void importLayout(const GraphLayout<K>& layout);
+		/// <summary>
+		/// Removes all vertices, edges and boundaries, invalidating their handles. The memory is kept for reuse.
+		/// </summary>
+		void clear();
+
 		/// <summary>
 		/// Ensures that all degree-2 vertices v have edge(0) = (u,v) and edge(1) = (v,w).
 		/// </summary>
@@ -74,6 +196,7 @@ namespace cartocrow::simplification {
 		template <class VD, class ED, typename K> friend class StraightEdge;
 		template <class VD, class ED, typename K> friend class StraightBoundary;
 		template <class InputGraph, class OutputGraph> friend OutputGraph* copy(InputGraph* input);
+		template <class InputGraph, class OutputGraph> friend OutputGraph* transfer(InputGraph*& input);
 
 	public:
 		using Kernel = K;
@@ -84,16 +207,22 @@ namespace cartocrow::simplification {
 
 	private:
 		int index;
+		int slot;
 		Point<K> point;
-		std::vector<Edge*> incident;
+		// most vertices have degree at most 3, so their incident edges are stored inline
+		detail::SmallVector<Edge*, 3> incident;
 		VD d;
 
 	public:
 		int graphIndex();
+		/// <summary>
+		/// Slot of this vertex in the handle table; unlike graphIndex(), this is stable under removal of other vertices.
+		/// </summary>
+		int handleSlot();
 		VD& data();
 
 		int degree();
-		std::vector<Edge*>& getEdges();
+		detail::SmallVector<Edge*, 3>& getEdges();
 
 		Edge* edge(int i);
 		Vertex* neighbor(int i);
@@ -130,6 +259,7 @@ namespace cartocrow::simplification {
 
 	private:
 		int index;
+		int slot;
 		Vertex* source;
 		Vertex* target;
 		Boundary* boundary;
@@ -137,6 +267,10 @@ namespace cartocrow::simplification {
 
 	public:
 		int graphIndex();
+		/// <summary>
+		/// Slot of this edge in the handle table; unlike graphIndex(), this is stable under removal of other edges.
+		/// </summary>
+		int handleSlot();
 		ED& data();
 
 		Vertex* getSource();
@@ -206,6 +340,13 @@ namespace cartocrow::simplification {
 	template<class InputGraph, class OutputGraph>
 	void copy(InputGraph* input, OutputGraph*&);
 
+	/// <summary>
+	/// Like copy, but consumes the input graph, which must have the same kernel as the output graph.
+	/// The vertex locations are moved rather than copied; the input is deleted and set to nullptr.
+	/// </summary>
+	template<class InputGraph, class OutputGraph>
+	OutputGraph* transfer(InputGraph*& input);
+
 } // namespace cartocrow::simplification
 
 #include "straight_graph.hpp"
\ No newline at end of file
@@ -3,10 +3,64 @@
 // Do not include this file, but the .h file instead
 // -----------------------------------------------------------------------------
 
+#include <algorithm>
+#include <numeric>
+
 #include "utils.h"
 
 namespace cartocrow::simplification {
 
+	template <class VD, class ED, typename K>
+	StraightVertex<VD, ED, K>* StraightGraph<VD, ED, K>::createVertex(Point<K>& pt) {
+		return createVertex(Point<K>(pt.x(), pt.y()));
+	}
+
+	template <class VD, class ED, typename K>
+	StraightVertex<VD, ED, K>* StraightGraph<VD, ED, K>::createVertex(Point<K>&& pt) {
+		Vertex* v = vertex_pool.create();
+		v->index = vertices.size();
+		v->slot = vertex_handles.acquire(v);
+		v->point = std::move(pt);
+		vertices.push_back(v);
+		return v;
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::destroyVertex(Vertex* v) {
+		vertex_handles.release(v->slot);
+		vertex_pool.destroy(v);
+	}
+
+	template <class VD, class ED, typename K>
+	StraightEdge<VD, ED, K>* StraightGraph<VD, ED, K>::createEdge(Vertex* source, Vertex* target) {
+		Edge* e = edge_pool.create();
+		e->index = edges.size();
+		e->slot = edge_handles.acquire(e);
+		e->source = source;
+		e->target = target;
+		e->boundary = nullptr;
+		edges.push_back(e);
+		return e;
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::destroyEdge(Edge* e) {
+		edge_handles.release(e->slot);
+		edge_pool.destroy(e);
+	}
+
+	template <class VD, class ED, typename K>
+	StraightBoundary<VD, ED, K>* StraightGraph<VD, ED, K>::createBoundary() {
+		Boundary* b = boundary_pool.create();
+		b->index = boundaries.size();
+		boundaries.push_back(b);
+		return b;
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::destroyBoundary(Boundary* b) {
+		boundary_pool.destroy(b);
+	}
 
 	template <class VD, class ED, typename K>
 	bool StraightGraph<VD, ED, K>::verifyOriented() {
@@ -68,7 +122,7 @@ namespace cartocrow::simplification {
 				e->boundary = nullptr;
 			}
 			for (Boundary* b : boundaries) {
-				delete b;
+				destroyBoundary(b);
 			}
 			boundaries.clear();
 
@@ -81,18 +135,21 @@ namespace cartocrow::simplification {
 	StraightGraph<VD, ED, K>::StraightGraph() {
 		oriented = false;
 		sorted = false;
+		thread_count = 1;
 	}
 
 	template <class VD, class ED, typename K>
 	StraightGraph<VD, ED, K>::~StraightGraph() {
-		for (Boundary* b : boundaries) {
-			delete b;
-		}
-		for (Edge* e : edges) {
-			delete e;
+		// only run the destructors where needed; the pools then release their slabs at once
+		if constexpr (!std::is_trivially_destructible_v<Edge>) {
+			for (Edge* e : edges) {
+				e->~Edge();
+			}
 		}
-		for (Vertex* v : vertices) {
-			delete v;
+		if constexpr (!std::is_trivially_destructible_v<Vertex>) {
+			for (Vertex* v : vertices) {
+				v->~Vertex();
+			}
 		}
 	}
 
@@ -139,16 +196,96 @@ namespace cartocrow::simplification {
 		return boundaries;
 	}
 
+	template <class VD, class ED, typename K>
+	size_t StraightGraph<VD, ED, K>::getReservedBytes() {
+		return vertex_pool.reservedBytes() + edge_pool.reservedBytes() + boundary_pool.reservedBytes()
+			+ vertices.capacity() * sizeof(Vertex*) + edges.capacity() * sizeof(Edge*) + boundaries.capacity() * sizeof(Boundary*);
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::setThreadCount(int threads) {
+		thread_count = std::max(1, threads);
+	}
+
+	template <class VD, class ED, typename K>
+	int StraightGraph<VD, ED, K>::getThreadCount() {
+		return thread_count;
+	}
+
+	template <class VD, class ED, typename K>
+	Handle<StraightVertex<VD, ED, K>> StraightGraph<VD, ED, K>::getHandle(Vertex* v) {
+		return vertex_handles.handleOf(v->slot);
+	}
+
+	template <class VD, class ED, typename K>
+	Handle<StraightEdge<VD, ED, K>> StraightGraph<VD, ED, K>::getHandle(Edge* e) {
+		return edge_handles.handleOf(e->slot);
+	}
+
+	template <class VD, class ED, typename K>
+	StraightVertex<VD, ED, K>* StraightGraph<VD, ED, K>::resolve(VertexHandle h) {
+		return vertex_handles.resolve(h);
+	}
+
+	template <class VD, class ED, typename K>
+	StraightEdge<VD, ED, K>* StraightGraph<VD, ED, K>::resolve(EdgeHandle h) {
+		return edge_handles.resolve(h);
+	}
+
+	template <class VD, class ED, typename K>
+	bool StraightGraph<VD, ED, K>::isValid(VertexHandle h) {
+		return vertex_handles.isValid(h);
+	}
+
+	template <class VD, class ED, typename K>
+	bool StraightGraph<VD, ED, K>::isValid(EdgeHandle h) {
+		return edge_handles.isValid(h);
+	}
+
+	template <class VD, class ED, typename K>
+	int StraightGraph<VD, ED, K>::getVertexSlotCount() {
+		return vertex_handles.slotCount();
+	}
+
+	template <class VD, class ED, typename K>
+	int StraightGraph<VD, ED, K>::getEdgeSlotCount() {
+		return edge_handles.slotCount();
+	}
+
+	template <class VD, class ED, typename K>
+	std::vector<int> StraightGraph<VD, ED, K>::compactVertexHandles() {
+		std::vector<int> old_slots;
+		old_slots.reserve(vertices.size());
+		for (Vertex* v : vertices) {
+			old_slots.push_back(v->slot);
+		}
+		std::vector<int> remap = vertex_handles.compact(vertices, old_slots);
+		for (Vertex* v : vertices) {
+			v->slot = v->index;
+		}
+		return remap;
+	}
+
+	template <class VD, class ED, typename K>
+	std::vector<int> StraightGraph<VD, ED, K>::compactEdgeHandles() {
+		std::vector<int> old_slots;
+		old_slots.reserve(edges.size());
+		for (Edge* e : edges) {
+			old_slots.push_back(e->slot);
+		}
+		std::vector<int> remap = edge_handles.compact(edges, old_slots);
+		for (Edge* e : edges) {
+			e->slot = e->index;
+		}
+		return remap;
+	}
+
 	template <class VD, class ED, typename K>
 	StraightVertex<VD, ED, K>* StraightGraph<VD, ED, K>::addVertex(Point<K> pt) {
 		clearBoundaries();
 		sorted = false;
 
-		Vertex* v = new Vertex();
-		v->index = vertices.size();
-		v->point = Point<K>(pt.x(), pt.y());
-		vertices.push_back(v);
-		return v;
+		return createVertex(pt);
 	}
 
 	template <class VD, class ED, typename K>
@@ -169,7 +306,7 @@ namespace cartocrow::simplification {
 				swp->index = e->index;
 			}
 
-			delete e;
+			destroyEdge(e);
 		}
 
 
@@ -177,7 +314,7 @@ namespace cartocrow::simplification {
 		if (swp != nullptr) {
 			swp->index = vtx->index;
 		}
-		delete vtx;
+		destroyVertex(vtx);
 	}
 
 	template <class VD, class ED, typename K>
@@ -188,11 +325,7 @@ namespace cartocrow::simplification {
 		clearBoundaries();
 		sorted = false;
 
-		Edge* e = new Edge();
-		e->index = edges.size();
-		e->source = source;
-		e->target = target;
-		edges.push_back(e);
+		Edge* e = createEdge(source, target);
 		source->incident.push_back(e);
 		target->incident.push_back(e);
 
@@ -214,7 +347,276 @@ namespace cartocrow::simplification {
 			swp->index = edge->index;
 		}
 
-		delete edge;
+		destroyEdge(edge);
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::reserve(int vertex_count, int edge_count) {
+		vertices.reserve(vertex_count);
+		edges.reserve(edge_count);
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::addEdges(const std::vector<std::pair<int, int>>& pairs) {
+		clearBoundaries();
+		sorted = false;
+
+		edges.reserve(edges.size() + pairs.size());
+
+		// size the incident lists up front, so that high-degree vertices grow at most once
+		std::vector<int> added(vertices.size(), 0);
+		for (auto [s, t] : pairs) {
+			added[s]++;
+			added[t]++;
+		}
+		for (Vertex* v : vertices) {
+			v->incident.reserve(v->incident.size() + added[v->index]);
+		}
+
+		// find repeated pairs by bucketing them by their lower endpoint, rather than by scanning the incident lists;
+		// buckets list the pairs in input order, so sorting them by the upper endpoint keeps the first occurrence first
+		std::vector<int> offsets(vertices.size() + 1, 0);
+		for (auto [s, t] : pairs) {
+			offsets[std::min(s, t) + 1]++;
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		std::vector<std::pair<int, int>> buckets(pairs.size());
+		std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+		for (int i = 0; i < pairs.size(); i++) {
+			auto [s, t] = pairs[i];
+			buckets[fill[std::min(s, t)]++] = { std::max(s, t), i };
+		}
+		std::vector<bool> repeated(pairs.size(), false);
+		for (int v = 0; v < vertices.size(); v++) {
+			auto first = buckets.begin() + offsets[v];
+			auto last = buckets.begin() + offsets[v + 1];
+			if (last - first > 1) {
+				std::sort(first, last);
+				for (auto it = first + 1; it != last; it++) {
+					repeated[it->second] = it->first == (it - 1)->first;
+				}
+			}
+		}
+		// only edges that were already in the graph still need the scan
+		bool existing = !edges.empty();
+
+		for (int i = 0; i < pairs.size(); i++) {
+			Vertex* source = vertices[pairs[i].first];
+			Vertex* target = vertices[pairs[i].second];
+			if (source == target || repeated[i] || (existing && source->isNeighborOf(target))) {
+				continue;
+			}
+
+			Edge* e = createEdge(source, target);
+			source->incident.push_back(e);
+			target->incident.push_back(e);
+		}
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::build(const std::vector<Point<K>>& points, const std::vector<std::pair<int, int>>& pairs) {
+		assert(vertices.empty() && edges.empty());
+
+		reserve(points.size(), pairs.size());
+		for (Point<K> pt : points) {
+			createVertex(pt);
+		}
+
+		addEdges(pairs);
+
+		orient();
+		sortIncidentEdges();
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::reorderSpatially(bool relocate) {
+		if (vertices.empty()) {
+			return;
+		}
+
+		std::vector<double> px(vertices.size()), py(vertices.size());
+		utils::parallelFor(vertices.size(), thread_count, [&](int i) {
+			px[i] = CGAL::to_double(vertices[i]->point.x());
+			py[i] = CGAL::to_double(vertices[i]->point.y());
+		});
+		auto [xmin, xmax] = std::minmax_element(px.begin(), px.end());
+		auto [ymin, ymax] = std::minmax_element(py.begin(), py.end());
+		double x0 = *xmin, y0 = *ymin;
+		double scale = 65535.0 / std::max({ *xmax - x0, *ymax - y0, std::numeric_limits<double>::min() });
+
+		// ties are broken by the current index, to make the order deterministic
+		std::vector<std::pair<std::uint64_t, int>> keyed(vertices.size());
+		utils::parallelFor(vertices.size(), thread_count, [&](int i) {
+			std::uint32_t gx = (std::uint32_t)((px[i] - x0) * scale);
+			std::uint32_t gy = (std::uint32_t)((py[i] - y0) * scale);
+			keyed[i] = { utils::hilbertIndex(gx, gy), i };
+		});
+		std::sort(keyed.begin(), keyed.end());
+
+		std::vector<Vertex*> old_vertices = vertices;
+		for (int i = 0; i < keyed.size(); i++) {
+			vertices[i] = old_vertices[keyed[i].second];
+			vertices[i]->index = i;
+		}
+
+		// edges are unique by their pair of endpoints
+		auto edgeKey = [](Edge* e) {
+			return std::minmax(e->source->index, e->target->index);
+		};
+		std::sort(edges.begin(), edges.end(), [&edgeKey](Edge* e, Edge* f) {
+			return edgeKey(e) < edgeKey(f);
+		});
+		for (int i = 0; i < edges.size(); i++) {
+			edges[i]->index = i;
+		}
+
+		if (relocate) {
+			relocateElements();
+		}
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::relocateElements() {
+		detail::SlabPool<Vertex> fresh_vertices;
+		detail::SlabPool<Edge> fresh_edges;
+
+		std::vector<Vertex*> old_vertices = vertices;
+		std::vector<Edge*> old_edges = edges;
+
+		for (int i = 0; i < vertices.size(); i++) {
+			vertices[i] = fresh_vertices.create(std::move(*old_vertices[i]));
+			vertex_handles.relocate(vertices[i]->slot, vertices[i]);
+		}
+		for (int i = 0; i < edges.size(); i++) {
+			edges[i] = fresh_edges.create(std::move(*old_edges[i]));
+			edge_handles.relocate(edges[i]->slot, edges[i]);
+		}
+
+		// the indices are retained, so all pointers can be redirected by index
+		utils::parallelFor(vertices.size(), thread_count, [&](int i) {
+			for (Edge*& e : vertices[i]->incident) {
+				e = edges[e->index];
+			}
+		});
+		utils::parallelFor(edges.size(), thread_count, [&](int i) {
+			edges[i]->source = vertices[edges[i]->source->index];
+			edges[i]->target = vertices[edges[i]->target->index];
+		});
+		for (Boundary* b : boundaries) {
+			b->first = edges[b->first->index];
+			b->last = edges[b->last->index];
+		}
+
+		if constexpr (!std::is_trivially_destructible_v<Edge>) {
+			for (Edge* e : old_edges) {
+				e->~Edge();
+			}
+		}
+		if constexpr (!std::is_trivially_destructible_v<Vertex>) {
+			for (Vertex* v : old_vertices) {
+				v->~Vertex();
+			}
+		}
+		vertex_pool = std::move(fresh_vertices);
+		edge_pool = std::move(fresh_edges);
+	}
+
+	template <class VD, class ED, typename K>
+	GraphLayout<K> StraightGraph<VD, ED, K>::exportLayout() {
+		GraphLayout<K> layout;
+
+		layout.points.reserve(vertices.size());
+		layout.incident_offsets.reserve(vertices.size() + 1);
+		layout.incident_offsets.push_back(0);
+		for (Vertex* v : vertices) {
+			layout.points.push_back(v->point);
+			for (Edge* e : v->incident) {
+				layout.incident.push_back(e->index);
+			}
+			layout.incident_offsets.push_back(layout.incident.size());
+		}
+
+		layout.edges.reserve(edges.size());
+		for (Edge* e : edges) {
+			layout.edges.emplace_back(e->source->index, e->target->index);
+		}
+
+		if (oriented) {
+			layout.boundaries.reserve(boundaries.size());
+			for (Boundary* b : boundaries) {
+				layout.boundaries.push_back({ b->first->index, b->last->index, b->cyclic });
+			}
+		}
+
+		layout.oriented = oriented;
+		layout.sorted = sorted;
+		return layout;
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::importLayout(const GraphLayout<K>& layout) {
+		assert(vertices.empty() && edges.empty());
+		assert(layout.incident_offsets.size() == layout.points.size() + 1);
+
+		reserve(layout.points.size(), layout.edges.size());
+		for (Point<K> pt : layout.points) {
+			createVertex(pt);
+		}
+		for (auto [s, t] : layout.edges) {
+			createEdge(vertices[s], vertices[t]);
+		}
+
+		utils::parallelFor(vertices.size(), thread_count, [&](int i) {
+			Vertex* v = vertices[i];
+			v->incident.reserve(layout.incident_offsets[i + 1] - layout.incident_offsets[i]);
+			for (int j = layout.incident_offsets[i]; j < layout.incident_offsets[i + 1]; j++) {
+				v->incident.push_back(edges[layout.incident[j]]);
+			}
+		});
+
+		if (layout.oriented) {
+			boundaries.reserve(layout.boundaries.size());
+			for (auto& bl : layout.boundaries) {
+				Boundary* b = createBoundary();
+				b->first = edges[bl.first];
+				b->last = edges[bl.last];
+				b->cyclic = bl.cyclic;
+			}
+
+			utils::parallelFor(boundaries.size(), thread_count, [&](int i) {
+				Boundary* b = boundaries[i];
+				Edge* e = b->first;
+				e->boundary = b;
+				while (e != b->last) {
+					e = e->next();
+					e->boundary = b;
+				}
+			});
+		}
+
+		oriented = layout.oriented;
+		sorted = layout.sorted;
+
+		assert(!oriented || verifyOriented());
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::clear() {
+		for (Boundary* b : boundaries) {
+			destroyBoundary(b);
+		}
+		for (Edge* e : edges) {
+			destroyEdge(e);
+		}
+		for (Vertex* v : vertices) {
+			destroyVertex(v);
+		}
+		boundaries.clear();
+		edges.clear();
+		vertices.clear();
+
+		oriented = false;
+		sorted = false;
 	}
 
 	template <class VD, class ED, typename K>
@@ -225,73 +627,220 @@ namespace cartocrow::simplification {
 
 		clearBoundaries();
 
-		for (Vertex* v : vertices) {
-			if (v->degree() != 2) continue; // irrelevant for orientation
+		if (thread_count > 1) {
+			std::vector<int> offsets;
+			std::vector<Vertex*> members;
+			labelChains(offsets, members);
+			orientChains(offsets, members);
+		}
+		else {
+			for (Vertex* v : vertices) {
+				orientAt(v);
+			}
+		}
 
-			Edge* bwd = v->incident[0];
-			Edge* fwd = v->incident[1];
+		oriented = true;
+	}
 
-			if (bwd->target == v && fwd->source == v) continue; // already satisfies orientation
-			if (bwd->source == v && fwd->target == v) {
-				// just swap (necessary to ensure direction between graph copies remains the same)
-				v->incident[0] = fwd;
-				v->incident[1] = bwd;
-				continue;
-			}
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::orientAt(Vertex* v) {
+		if (v->degree() != 2) return; // irrelevant for orientation
+
+		Edge* bwd = v->incident[0];
+		Edge* fwd = v->incident[1];
+
+		if (bwd->target == v && fwd->source == v) return; // already satisfies orientation
+		if (bwd->source == v && fwd->target == v) {
+			// just swap (necessary to ensure direction between graph copies remains the same)
+			v->incident[0] = fwd;
+			v->incident[1] = bwd;
+			return;
+		}
+
+		if (bwd->target != v) {
+			bwd->reverse();
+		}
+
+		if (fwd->source != v) {
+			fwd->reverse();
+		}
 
-			if (bwd->target != v) {
-				bwd->reverse();
+		Vertex* fv = fwd->target;
+		while (fv->degree() == 2 && fv != v) {
+			if (fv->incident[0] != fwd) {
+				fv->incident[1] = fv->incident[0];
+				fv->incident[0] = fwd;
 			}
 
-			if (fwd->source != v) {
+			fwd = fv->incident[1];
+			if (fwd->source != fv) {
 				fwd->reverse();
 			}
+			fv = fwd->target;
+		}
 
-			Vertex* fv = fwd->target;
-			while (fv->degree() == 2 && fv != v) {
-				if (fv->incident[0] != fwd) {
-					fv->incident[1] = fv->incident[0];
-					fv->incident[0] = fwd;
+		if (fv != v) {
+			Vertex* bv = bwd->source;
+			while (bv->degree() == 2) {
+				if (bv->incident[1] != bwd) {
+					bv->incident[0] = bv->incident[1];
+					bv->incident[1] = bwd;
 				}
 
-				fwd = fv->incident[1];
-				if (fwd->source != fv) {
-					fwd->reverse();
+				bwd = bv->incident[0];
+				if (bwd->target != bv) {
+					bwd->reverse();
 				}
-				fv = fwd->target;
+				bv = bwd->source;
 			}
+		}
+	}
 
-			if (fv != v) {
-				Vertex* bv = bwd->source;
-				while (bv->degree() == 2) {
-					if (bv->incident[1] != bwd) {
-						bv->incident[0] = bv->incident[1];
-						bv->incident[1] = bwd;
-					}
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::labelChains(std::vector<int>& offsets, std::vector<Vertex*>& members) {
+		std::vector<int> chain(vertices.size(), -1);
+		int count = 0;
 
-					bwd = bv->incident[0];
-					if (bwd->target != bv) {
-						bwd->reverse();
-					}
-					bv = bwd->source;
+		for (Vertex* v : vertices) {
+			if (v->degree() != 2 || chain[v->index] >= 0) continue;
+
+			chain[v->index] = count;
+			for (Edge* e : v->incident) {
+				Vertex* w = e->other(v);
+				while (w->degree() == 2 && chain[w->index] < 0) {
+					chain[w->index] = count;
+					e = w->incident[0] == e ? w->incident[1] : w->incident[0];
+					w = e->other(w);
 				}
 			}
+			count++;
 		}
 
-		oriented = true;
+		offsets.assign(count + 1, 0);
+		for (Vertex* v : vertices) {
+			if (chain[v->index] >= 0) {
+				offsets[chain[v->index] + 1]++;
+			}
+		}
+		for (int c = 0; c < count; c++) {
+			offsets[c + 1] += offsets[c];
+		}
+
+		// fill in order of graph index, such that each chain lists its members in that order
+		members.resize(offsets[count]);
+		std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+		for (Vertex* v : vertices) {
+			if (chain[v->index] >= 0) {
+				members[fill[chain[v->index]]++] = v;
+			}
+		}
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::orientChains(std::vector<int>& offsets, std::vector<Vertex*>& members) {
+		// orientAt only modifies the chain it is called on, and chains share no degree-2 vertices or edges;
+		// handling each chain in order of graph index then gives the same result as the serial loop
+		utils::parallelFor(offsets.size() - 1, thread_count, [&](int c) {
+			for (int i = offsets[c]; i < offsets[c + 1]; i++) {
+				orientAt(members[i]);
+			}
+		});
+	}
+
+	template <class VD, class ED, typename K>
+	void StraightGraph<VD, ED, K>::buildBoundaries(std::vector<int>& offsets, std::vector<Vertex*>& members) {
+		// the serial construction numbers the boundaries by their lowest edge index, which we reproduce here
+		struct Record {
+			int min_edge;
+			Edge* first;
+			Edge* last;
+			bool cyclic;
+		};
+
+		int chains = offsets.size() - 1;
+		std::vector<Record> records(chains);
+
+		utils::parallelFor(chains, thread_count, [&](int c) {
+			Vertex* v = members[offsets[c]];
+			Record& r = records[c];
+
+			r.first = v->incoming();
+			while (r.first->source->degree() == 2 && r.first->source != v) {
+				r.first = r.first->previous();
+			}
+			r.cyclic = r.first->source == v;
+
+			r.min_edge = r.first->index;
+			if (r.cyclic) {
+				for (Edge* e = r.first->next(); e != r.first; e = e->next()) {
+					r.min_edge = std::min(r.min_edge, e->index);
+				}
+				r.first = edges[r.min_edge];
+				r.last = r.first->previous();
+			}
+			else {
+				r.last = r.first;
+				while (r.last->target->degree() == 2) {
+					r.last = r.last->next();
+					r.min_edge = std::min(r.min_edge, r.last->index);
+				}
+			}
+		});
+
+		// edges between two vertices of degree other than 2 each form a boundary by themselves
+		for (Edge* e : edges) {
+			if (e->source->degree() != 2 && e->target->degree() != 2) {
+				records.push_back({ e->index, e, e, false });
+			}
+		}
+
+		std::sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+			return a.min_edge < b.min_edge;
+		});
+
+		boundaries.reserve(records.size());
+		for (Record& r : records) {
+			Boundary* b = createBoundary();
+			b->first = r.first;
+			b->last = r.last;
+			b->cyclic = r.cyclic;
+		}
+
+		utils::parallelFor(records.size(), thread_count, [&](int i) {
+			Boundary* b = boundaries[i];
+			Edge* e = b->first;
+			e->boundary = b;
+			while (e != b->last) {
+				e = e->next();
+				e->boundary = b;
+			}
+		});
 	}
 
 	template <class VD, class ED, typename K>
 	void StraightGraph<VD, ED, K>::orient() {
+		if (thread_count > 1 && !oriented) {
+			// share the chains between orienting and constructing boundaries
+			std::vector<int> offsets;
+			std::vector<Vertex*> members;
+			labelChains(offsets, members);
+
+			clearBoundaries();
+			orientChains(offsets, members);
+			oriented = true;
+			buildBoundaries(offsets, members);
+
+			assert(verifyOriented());
+			return;
+		}
+
 		orientWithoutBoundaries();
 
 		// construct boundaries
 		for (Edge* e : edges) {
 			if (e->boundary != nullptr) continue; // already handled
 
-			Boundary* b = new Boundary();
-			b->index = boundaries.size();
-			boundaries.push_back(b);
+			Boundary* b = createBoundary();
 
 			e->boundary = b;
 
@@ -326,16 +875,42 @@ namespace cartocrow::simplification {
 
 	template <class VD, class ED, typename K>
 	void StraightGraph<VD, ED, K>::sortIncidentEdges() {
-		for (Vertex* v : vertices) {
-			if (v->degree() > 2) {
-				std::ranges::sort(v->incident, [&v](Edge* e, Edge* f) {
-					using Dir = Direction<K>;
-					Dir dir_e = Dir(e->other(v)->getPoint() - v->getPoint());
-					Dir dir_f = Dir(f->other(v)->getPoint() - v->getPoint());
-					return dir_e < dir_f;
-					});
+		struct Keyed {
+			// interval containing the pseudo-angle of the edge direction
+			std::pair<double, double> angle;
+			Edge* edge;
+		};
+
+		utils::parallelFor(vertices.size(), thread_count, [&](int i) {
+			Vertex* v = vertices[i];
+			if (v->degree() <= 2) {
+				return;
 			}
-		}
+
+			std::vector<Keyed> keyed;
+			keyed.reserve(v->degree());
+			for (Edge* e : v->incident) {
+				keyed.push_back({ utils::pseudoAngleInterval<K>(e->other(v)->getPoint() - v->getPoint()), e });
+			}
+
+			// disjoint intervals decide the order; only overlapping ones need the exact directions
+			std::sort(keyed.begin(), keyed.end(), [&v](const Keyed& a, const Keyed& b) {
+				if (a.angle.second < b.angle.first) {
+					return true;
+				}
+				if (b.angle.second < a.angle.first) {
+					return false;
+				}
+				using Dir = Direction<K>;
+				Dir dir_a = Dir(a.edge->other(v)->getPoint() - v->getPoint());
+				Dir dir_b = Dir(b.edge->other(v)->getPoint() - v->getPoint());
+				return dir_a < dir_b;
+				});
+
+			for (int j = 0; j < keyed.size(); j++) {
+				v->incident[j] = keyed[j].edge;
+			}
+		});
 		sorted = true;
 		assert(verifySorted());
 	}
@@ -344,22 +919,15 @@ namespace cartocrow::simplification {
 	StraightVertex<VD, ED, K>* StraightGraph<VD, ED, K>::splitEdge(Edge* edge, Point<K> pt) {
 		assert(oriented && verifyOriented());
 
-		Vertex* v = new Vertex();
-		v->index = vertices.size();
-		v->point = Point<K>(pt.x(), pt.y());
-		vertices.push_back(v);
+		Vertex* v = createVertex(pt);
 
 		Vertex* w = edge->target;
 
 		edge->target = v;
 		v->incident.push_back(edge);
 
-		Edge* newedge = new Edge();
-		newedge->index = edges.size();
-		newedge->source = v;
-		newedge->target = w;
+		Edge* newedge = createEdge(v, w);
 		newedge->boundary = edge->boundary;
-		edges.push_back(newedge);
 
 		if (edge->boundary->last == edge) {
 			edge->boundary->last = newedge;
@@ -402,14 +970,14 @@ namespace cartocrow::simplification {
 		if (eswp != nullptr) {
 			eswp->index = other->index;
 		}
-		delete other;
+		destroyEdge(other);
 
 		// delete the vertex: no need to clear edges anymore
 		Vertex* vswp = utils::swapRemove(v->index, vertices);
 		if (vswp != nullptr) {
 			vswp->index = v->index;
 		}
-		delete v;
+		destroyVertex(v);
 
 		assert(oriented && verifyOriented());
 
@@ -425,13 +993,18 @@ namespace cartocrow::simplification {
 	int StraightVertex<VD, ED, K>::graphIndex() {
 		return index;
 	}
+
+	template <class VD, class ED, typename K>
+	int StraightVertex<VD, ED, K>::handleSlot() {
+		return slot;
+	}
 	template <class VD, class ED, typename K>
 	int StraightVertex<VD, ED, K>::degree() {
 		return incident.size();
 	}
 
 	template <class VD, class ED, typename K>
-	std::vector<StraightEdge<VD, ED, K>*>& StraightVertex<VD, ED, K>::getEdges() {
+	detail::SmallVector<StraightEdge<VD, ED, K>*, 3>& StraightVertex<VD, ED, K>::getEdges() {
 		return incident;
 	}
 
@@ -516,6 +1089,11 @@ namespace cartocrow::simplification {
 		return index;
 	}
 
+	template <class VD, class ED, typename K>
+	int StraightEdge<VD, ED, K>::handleSlot() {
+		return slot;
+	}
+
 	template <class VD, class ED, typename K>
 	StraightVertex<VD, ED, K>* StraightEdge<VD, ED, K>::getSource() {
 		return source;
@@ -620,66 +1198,97 @@ namespace cartocrow::simplification {
 	}
 
 
+	template <class VD, class ED, typename K>
+	template <class InputGraph>
+	void StraightGraph<VD, ED, K>::copyStructure(InputGraph* input, std::vector<Point<K>>&& points) {
+		assert(vertices.empty() && edges.empty());
+
+		// all elements are created in the order of the input, such that indices match
+		reserve(points.size(), input->edges.size());
+		for (Point<K>& pt : points) {
+			createVertex(std::move(pt));
+		}
+		for (auto* e : input->edges) {
+			createEdge(vertices[e->source->index], vertices[e->target->index]);
+		}
+
+		// copying the incident lists verbatim retains orientation and sorting, so neither needs to be recomputed
+		utils::parallelFor(vertices.size(), thread_count, [&](int i) {
+			auto& in_incident = input->vertices[i]->incident;
+			Vertex* v = vertices[i];
+			v->incident.reserve(in_incident.size());
+			for (auto* e : in_incident) {
+				v->incident.push_back(edges[e->index]);
+			}
+		});
+
+		if (input->oriented) {
+			boundaries.reserve(input->boundaries.size());
+			for (auto* bd : input->boundaries) {
+				Boundary* b = createBoundary();
+				b->cyclic = bd->cyclic;
+				b->first = edges[bd->first->index];
+				b->last = edges[bd->last->index];
+			}
+
+			utils::parallelFor(edges.size(), thread_count, [&](int i) {
+				edges[i]->boundary = boundaries[input->edges[i]->boundary->index];
+			});
+		}
+
+		oriented = input->oriented;
+		sorted = input->sorted;
+	}
+
 	template<class InputGraph, class OutputGraph>
 	OutputGraph* copy(InputGraph* input) {
 
-		using InVertex = InputGraph::Vertex;
-		using InEdge = InputGraph::Edge;
-		using InBoundary = InputGraph::Boundary;
 		using InKernel = InputGraph::Kernel;
-
-		using OutVertex = OutputGraph::Vertex;
-		using OutEdge = OutputGraph::Edge;
-		using OutBoundary = OutputGraph::Boundary;
 		using OutKernel = OutputGraph::Kernel;
 
 		OutputGraph* output = new OutputGraph();
-
-		if constexpr (std::is_same<InKernel, OutKernel>::value) {
-			for (InVertex* v : input->vertices) {
-				output->addVertex(v->point);
+		output->setThreadCount(input->thread_count);
+
+		// convert the coordinates up front, in parallel
+		int n = input->vertices.size();
+		std::vector<Point<OutKernel>> points(n);
+		utils::parallelFor(n, input->thread_count, [&](int i) {
+			Point<InKernel>& pt = input->vertices[i]->point;
+			if constexpr (std::is_same<InKernel, OutKernel>::value) {
+				points[i] = pt;
 			}
-		}
-		else {
-			CGAL::Cartesian_converter<InKernel, OutKernel> convert;
-			for (InVertex* v : input->vertices) {
-				output->addVertex(convert(v->point));
+			else {
+				CGAL::Cartesian_converter<InKernel, OutKernel> convert;
+				points[i] = convert(pt);
 			}
-		}
+		});
 
-		for (InEdge* e : input->edges) {
-			OutVertex* out_src = output->vertices[e->source->index];
-			OutVertex* out_tar = output->vertices[e->target->index];
-			output->addEdge(out_src, out_tar);
-		}
+		output->copyStructure(input, std::move(points));
 
-		if (input->oriented) {
-			// we oriented without constructing boundaries
-			// to then copy the boundaries explicitly
-			// -- this is done to ensure that indices match afterwards
-			output->orientWithoutBoundaries();
-
-			for (InBoundary* bd : input->boundaries) {
-				OutBoundary* tarbd = new OutBoundary();
-				tarbd->index = bd->index;
-				tarbd->cyclic = bd->cyclic;
-				tarbd->first = output->edges[bd->first->index];
-				tarbd->last = output->edges[bd->last->index];
-				output->boundaries.push_back(tarbd);
-
-				OutEdge* e = tarbd->first;
-				e->boundary = tarbd;
-				while (e != tarbd->last) {
-					e = e->next();
-					e->boundary = tarbd;
-				}
-			}
-		}
+		return output;
+	}
+
+	template<class InputGraph, class OutputGraph>
+	OutputGraph* transfer(InputGraph*& input) {
+		static_assert(std::is_same<typename InputGraph::Kernel, typename OutputGraph::Kernel>::value,
+			"transfer requires graphs with the same kernel, use copy instead");
+
+		using K = OutputGraph::Kernel;
 
-		if (input->sorted) {
-			output->sortIncidentEdges();
+		OutputGraph* output = new OutputGraph();
+		output->setThreadCount(input->thread_count);
+
+		std::vector<Point<K>> points;
+		points.reserve(input->vertices.size());
+		for (auto* v : input->vertices) {
+			points.push_back(std::move(v->point));
 		}
 
+		output->copyStructure(input, std::move(points));
+
+		delete input;
+		input = nullptr;
+
 		return output;
 	}
 
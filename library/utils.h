@@ -2,6 +2,18 @@
 
 #include <cartocrow/core/core.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace cartocrow::simplification::utils {
 
 	template <typename K>
@@ -163,8 +175,8 @@ namespace cartocrow::simplification::utils {
 		}
 	}
 
-	template<typename T>
-	bool listRemove(T* elt, std::vector<T*>& vec) {
+	template<typename T, typename List>
+	bool listRemove(T* elt, List& vec) {
 
 		auto pos = std::find(vec.begin(), vec.end(), elt);
 		if (pos != vec.end()) {
@@ -189,8 +201,8 @@ namespace cartocrow::simplification::utils {
 		}
 	}
 
-	template<typename T>
-	void listReplace(T* oldelt, T* newelt, std::vector<T*>& vec) {
+	template<typename T, typename List>
+	void listReplace(T* oldelt, T* newelt, List& vec) {
 		for (int i = 0; i < vec.size(); i++) {
 			if (vec[i] == oldelt) {
 				vec[i] = newelt;
@@ -201,4 +213,235 @@ namespace cartocrow::simplification::utils {
 		assert(false);
 
 	}
+
+	/// <summary>
+	/// Monotone substitute for the counterclockwise angle of a nonzero vector (dx, dy) with the positive x-axis, in [0, 4).
+	/// </summary>
+	inline double pseudoAngle(double dx, double dy) {
+		double t = dy / (std::abs(dx) + std::abs(dy));
+		if (dx >= 0) {
+			return dy >= 0 ? t : 4 + t;
+		}
+		else {
+			return 2 - t;
+		}
+	}
+
+	/// <summary>
+	/// Interval that contains the pseudo-angle of the vector, computed from the interval approximations of its
+	/// coordinates. Vectors with disjoint intervals are ordered by them the same as by comparing Direction objects.
+	/// The interval is unbounded if a coordinate interval contains zero without being exactly zero, as the vector may
+	/// then lie on either side of an axis.
+	/// </summary>
+	template<typename K>
+	std::pair<double, double> pseudoAngleInterval(const Vector<K>& d) {
+		constexpr double inf = std::numeric_limits<double>::infinity();
+		auto [xlo, xhi] = CGAL::to_interval(d.x());
+		auto [ylo, yhi] = CGAL::to_interval(d.y());
+		auto straddles = [](double lo, double hi) {
+			return lo <= 0 && hi >= 0 && (lo < 0 || hi > 0);
+		};
+		if (straddles(xlo, xhi) || straddles(ylo, yhi)) {
+			return { -inf, inf };
+		}
+
+		// within a quadrant, the pseudo-angle is monotone in each coordinate, so its extremes lie at the corners
+		double lo = inf;
+		double hi = -inf;
+		for (double x : { xlo, xhi }) {
+			for (double y : { ylo, yhi }) {
+				double a = pseudoAngle(x, y);
+				lo = std::min(lo, a);
+				hi = std::max(hi, a);
+			}
+		}
+		if (!(lo <= hi)) {
+			// the zero vector, or coordinates too large for doubles
+			return { -inf, inf };
+		}
+		// each evaluation rounds a quotient of magnitude at most 1 and a sum of magnitude at most 4
+		constexpr double err = 8 * std::numeric_limits<double>::epsilon();
+		return { lo - err, hi + err };
+	}
+
+	/// <summary>
+	/// Position of grid cell (x, y) along the Hilbert curve through a 2^16 x 2^16 grid.
+	/// </summary>
+	inline std::uint64_t hilbertIndex(std::uint32_t x, std::uint32_t y) {
+		constexpr std::uint32_t n = 1u << 16;
+		std::uint64_t d = 0;
+		for (std::uint32_t s = n / 2; s > 0; s >>= 1) {
+			std::uint32_t rx = (x & s) > 0;
+			std::uint32_t ry = (y & s) > 0;
+			d += (std::uint64_t)s * s * ((3 * rx) ^ ry);
+			// rotate the quadrant
+			if (ry == 0) {
+				if (rx == 1) {
+					x = n - 1 - x;
+					y = n - 1 - y;
+				}
+				std::swap(x, y);
+			}
+		}
+		return d;
+	}
+
+	/// <summary>
+	/// Calls f(i) for all 0 <= i < count, using the given number of threads (including the calling thread).
+	/// Threads claim small consecutive ranges of i, such that uneven work per i is balanced.
+	/// </summary>
+	template<typename F>
+	void parallelFor(int count, int threads, F&& f) {
+		if (threads <= 1 || count < 2) {
+			for (int i = 0; i < count; i++) {
+				f(i);
+			}
+			return;
+		}
+
+		threads = std::min(threads, count);
+		const int grain = std::max(1, count / (threads * 16));
+		std::atomic<int> next = 0;
+
+		auto work = [&]() {
+			int begin;
+			while ((begin = next.fetch_add(grain)) < count) {
+				int end = std::min(count, begin + grain);
+				for (int i = begin; i < end; i++) {
+					f(i);
+				}
+			}
+		};
+
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+		for (int t = 1; t < threads; t++) {
+			workers.emplace_back(work);
+		}
+		work();
+		for (std::thread& w : workers) {
+			w.join();
+		}
+	}
+
+	/// <summary>
+	/// Threads that are started once and then run parallelFor loops on request. Algorithms that run many short loops
+	/// use this rather than utils::parallelFor, as starting threads for every loop would cost about as much as the loop.
+	/// Idle threads wait without using the processor. Loops must not be run from several threads at once.
+	/// </summary>
+	class WorkerPool {
+	public:
+		WorkerPool() {}
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		~WorkerPool() {
+			resize(1);
+		}
+
+		/// <summary>
+		/// Sets the number of threads that run loops, including the calling thread.
+		/// </summary>
+		void resize(int threads) {
+			if (threads - 1 == static_cast<int>(workers.size())) {
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (std::thread& w : workers) {
+				w.join();
+			}
+			workers.clear();
+
+			// a worker that starts late still joins the loops from this generation on
+			stopping = false;
+			for (int t = 1; t < threads; t++) {
+				workers.emplace_back([this, served = generation]() { serve(served); });
+			}
+		}
+
+		int size() const {
+			return static_cast<int>(workers.size()) + 1;
+		}
+
+		/// <summary>
+		/// Calls f(i) for all 0 <= i < count, as utils::parallelFor.
+		/// </summary>
+		template <typename F> void parallelFor(int count, F&& f) {
+			if (workers.empty() || count < 2) {
+				for (int i = 0; i < count; i++) {
+					f(i);
+				}
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				body = [](void* context, int i) {
+					(*static_cast<std::remove_reference_t<F>*>(context))(i);
+				};
+				context = &f;
+				total = count;
+				grain = std::max(1, count / (size() * 16));
+				next = 0;
+				busy = static_cast<int>(workers.size());
+				generation++;
+			}
+			wake.notify_all();
+
+			work();
+
+			std::unique_lock<std::mutex> lock(mutex);
+			finished.wait(lock, [this]() { return busy == 0; });
+		}
+
+	private:
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable finished;
+		bool stopping = false;
+
+		// the current loop, which every worker joins once per generation
+		void (*body)(void*, int) = nullptr;
+		void* context = nullptr;
+		int total = 0;
+		int grain = 1;
+		std::atomic<int> next = 0;
+		int busy = 0;
+		std::uint64_t generation = 0;
+
+		void work() {
+			int begin;
+			while ((begin = next.fetch_add(grain)) < total) {
+				int end = std::min(total, begin + grain);
+				for (int i = begin; i < end; i++) {
+					body(context, i);
+				}
+			}
+		}
+
+		void serve(std::uint64_t served) {
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true) {
+				wake.wait(lock, [&]() { return stopping || generation != served; });
+				if (stopping) {
+					return;
+				}
+				served = generation;
+
+				lock.unlock();
+				work();
+				lock.lock();
+
+				if (--busy == 0) {
+					finished.notify_one();
+				}
+			}
+		}
+	};
 }
\ No newline at end of file
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <cartocrow/core/core.h>
-#include <cartocrow/datastructures/indexed_priority_queue.h>
 
+#include "blocking_links.h"
+#include "elimination_sequence.h"
+#include "filtered_predicates.h"
 #include "vertex_quad_tree.h"
 #include "straight_graph.h"
 #include "modifiable_graph.h"
 #include "historic_graph.h"
+#include "indexed_heap.h"
 #include "common.h"
+#include "utils.h"
 
 namespace cartocrow::simplification {
 
@@ -23,13 +27,17 @@ namespace cartocrow::simplification {
 		    	v->data().cost
 		    } -> std::same_as<Number<typename MG::Kernel>&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
 		    
+		    {
+		    	v->data().cost_approx
+		    } -> std::same_as<CostInterval&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
+		    
 		    {
 		    	v->data().blocked_by
-		    } -> std::same_as<std::vector<typename MG::Vertex*>&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
+		    } -> std::same_as<BlockedByList<typename MG::Vertex>&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
 		    
 		    {
 		    	v->data().blocking
-		    } -> std::same_as<std::vector<typename MG::Vertex*>&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
+		    } -> std::same_as<BlockingToList<typename MG::Vertex>&>; // c++ shenanigans: the expression is still a handle, even if it's declared as a nonhandle.
 		    
 		    {
 		    	v->data().qid
@@ -70,29 +78,106 @@ namespace cartocrow::simplification {
 	/// <typeparam name="MG">Modifiable Graph type to be used; typically, will be one of VertexRemovalGraph or HistoricVertexRemovalGraph</typeparam>
 	/// <typeparam name="VRT">VertexRemovalTraits, specifying the desired cost function</typeparam>
 	template <class MG, class VRT>
-		requires detail::VRSetup<MG, VRT> class VertexRemoval {
+		requires detail::VRSetup<MG, VRT> class VertexRemoval : private detail::HistoryObserverOf<MG>::type {
 
 		public:
 			using Vertex = MG::Vertex;
+			using Edge = MG::Edge;
 			using Kernel = MG::Kernel;
 			using VertexTree = VertexQuadTree<MG>;
 
 		private:
 			MG& graph;
 			VertexTree& pqt;
-			cartocrow::datastructures::IndexedPriorityQueue<GraphQueueTraits<Vertex, Kernel>> queue;
+			detail::IndexedHeap<GraphQueueTraits<Vertex, Kernel>> queue;
+			detail::BlockingRelations<Vertex> relations;
+			PredicateStats stats;
+			int thread_count = 1;
+			utils::WorkerPool workers;
+			bool parallel_rounds = false;
+			double cost_slack = 0;
+			EliminationSequence<Kernel>* sequence = nullptr;
+
+			// vertices around the changes made by recalling history, to be updated by resume(); once the graph was
+			// rebuilt or too many changes were made, the changes are no longer followed and resume() initializes
+			std::vector<Handle<Vertex>> touched;
+			bool rebuilt = false;
+
+			void touch(Vertex* v);
+			void forget(Vertex* v);
+
+			// keeps the search structure, queue and blocking relations in sync while history is recalled
+			void beforeMerge(Vertex* v);
+			void afterMerge(Edge* e);
+			void beforeSplit(Edge* e);
+			void afterSplit(Vertex* v);
+			void beforeShift(Vertex* v);
+			void afterShift(Vertex* v);
+			void afterRebuild();
 
 			void update(Vertex* v);
+			/// <summary>
+			/// Computes the cost of removing the degree-2 vertex, and returns whether it can be removed at all. Only writes the data of the vertex.
+			/// </summary>
+			bool evaluate(Vertex* v);
+			void enqueue(Vertex* v, bool removable);
 
+			template <typename F> void findBlockers(Vertex* v, PredicateStats& counts, F&& blocked);
 			Vertex* findNextStep();
 			void performStep(Vertex* v);
+			void removeVertex(Vertex* v);
+			bool runRounds(std::optional<std::function<bool(int, Number<Kernel>)>> stop);
 		public:
 			VertexRemoval(MG& g, VertexTree& qt);
 			~VertexRemoval();
 
 			void initialize(bool initQuadTree);
+			/// <summary>
+			/// Prepares the algorithm to run further after history was recalled, by updating only the vertices around
+			/// the operations that were undone or redone; the search structure is kept up to date while recalling.
+			/// This takes time proportional to the number of recalled operations, rather than to the size of the graph.
+			/// If the graph was rebuilt from a checkpoint or a stream, or the recalled operations touched more than half
+			/// of its vertices, the algorithm is initialized from scratch instead.
+			/// Only the last algorithm constructed on a historic graph is kept up to date.
+			/// </summary>
+			void resume();
 			bool run(std::optional<std::function<bool(int, Number<Kernel>)>> stop = std::nullopt);
 			bool step();
+
+			/// <summary>
+			/// Sets the number of threads used by initialize, which computes the costs concurrently, and by the rounds of
+			/// run if these are enabled. The threads are started here, and kept until the number changes.
+			/// </summary>
+			void setThreadCount(int threads);
+			int getThreadCount() const;
+
+			/// <summary>
+			/// Sets whether run works in rounds. Each round takes the cheapest vertices from the queue whose triangles
+			/// share no vertices, tests them for blocking concurrently, and then removes the unblocked ones in order of
+			/// cost. Each removal is still a separate history batch.
+			/// </summary>
+			void setParallelRounds(bool rounds);
+			bool getParallelRounds() const;
+
+			/// <summary>
+			/// Sets the relative cost slack of a round: a round only takes vertices with cost at most (1 + slack) times
+			/// the cheapest cost. A larger slack deviates more from the greedy order, but allows larger rounds.
+			/// </summary>
+			void setCostSlack(double slack);
+			double getCostSlack() const;
+
+			/// <summary>
+			/// Records the steps of subsequent runs into the sequence, which starts from the current state of the graph.
+			/// Pass nullptr to stop recording.
+			/// </summary>
+			void setEliminationSequence(EliminationSequence<Kernel>* seq);
+
+			/// <summary>
+			/// Counts of the blocking tests decided by the floating-point filter and by the exact kernel.
+			/// </summary>
+			const PredicateStats& getPredicateStats() const {
+				return stats;
+			}
 	};
 
 
@@ -3,6 +3,8 @@
 // Do not include this file, but the .h file instead
 // -----------------------------------------------------------------------------
 
+#include <unordered_set>
+
 #include "utils.h"
 
 namespace cartocrow::simplification {
@@ -11,8 +13,9 @@ namespace cartocrow::simplification {
 		template <class V, typename K>
 		struct VRBase {
 			Number<K> cost;
-			std::vector<V*> blocked_by;
-			std::vector<V*> blocking;
+			CostInterval cost_approx;
+			BlockedByList<V> blocked_by;
+			BlockingToList<V> blocking;
 			int qid;
 		};
 
@@ -24,16 +27,24 @@ namespace cartocrow::simplification {
 		};
 
 		template <typename K> struct HVREdge {
-			Operation<HVRGraph<K>>* hist = nullptr;
+			int hist = -1;
 		};
 	}
 
 	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
 	VertexRemoval<MG,VRT>::VertexRemoval(MG& g, VertexTree& qt) : graph(g), pqt(qt) {
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			graph.setObserver(this);
+		}
 	}
 
 	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
 	VertexRemoval<MG, VRT>::~VertexRemoval() {
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			if (graph.getObserver() == this) {
+				graph.setObserver(nullptr);
+			}
+		}
 	}
 
 	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
@@ -46,13 +57,144 @@ namespace cartocrow::simplification {
 			}
 		}
 
+		// start from scratch: relations may still refer to vertices that were removed by recalling history
 		for (Vertex* v : graph.getVertices()) {
-			update(v);
+			v->data().blocked_by.reset();
+			v->data().blocking.reset();
+		}
+		relations.clear();
+
+		// the costs are independent, compute them concurrently before building the queue in one go
+		std::vector<Vertex*>& vertices = graph.getVertices();
+		std::vector<char> removable(vertices.size());
+		workers.parallelFor(vertices.size(), [&](int i) {
+			removable[i] = vertices[i]->degree() == 2 && evaluate(vertices[i]);
+			});
+
+		std::vector<Vertex*> queued;
+		for (int i = 0; i < vertices.size(); i++) {
+			if (removable[i]) {
+				queued.push_back(vertices[i]);
+			}
+		}
+		queue.build(std::move(queued));
+
+		touched.clear();
+		rebuilt = false;
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::resume() {
+		if (rebuilt) {
+			initialize(true);
+			return;
+		}
+
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			// the removability of a vertex depends on its neighbors, whose adjacency may have changed
+			for (Handle<Vertex> h : touched) {
+				Vertex* v = graph.getBaseGraph().resolve(h);
+				if (v == nullptr) {
+					continue;
+				}
+				update(v);
+				for (int i = 0; i < v->degree(); i++) {
+					update(v->neighbor(i));
+				}
+			}
+		}
+		touched.clear();
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::touch(Vertex* v) {
+		if constexpr (ModifiableGraphWithHistory<MG>) {
+			touched.push_back(graph.getBaseGraph().getHandle(v));
+
+			// resume() updates each touched vertex and its neighbors, so beyond half the graph it costs more than
+			// initializing; stop following the changes then, which also bounds the memory spent on them
+			if (2 * touched.size() > graph.getVertices().size()) {
+				rebuilt = true;
+				touched.clear();
+				touched.shrink_to_fit();
+			}
+		}
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::forget(Vertex* v) {
+		pqt.remove(*v);
+		queue.remove(v);
+		relations.clearBlocking(v, [this](Vertex* b) {
+			if (b->data().blocked_by.empty()) {
+				queue.push(b);
+			}
+			});
+		relations.clearBlockedBy(v);
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::beforeMerge(Vertex* v) {
+		if (rebuilt) {
+			return;
+		}
+		touch(v->previous());
+		touch(v->next());
+		forget(v);
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::afterMerge(Edge* e) {}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::beforeSplit(Edge* e) {}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::afterSplit(Vertex* v) {
+		if (rebuilt) {
+			return;
 		}
+		v->data().qid = -1;
+		pqt.insert(*v);
+		touch(v);
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::beforeShift(Vertex* v) {
+		if (rebuilt) {
+			return;
+		}
+		// the vertices blocked by this one are tested again once they reach the front of the queue
+		pqt.remove(*v);
+		relations.clearBlocking(v, [this](Vertex* b) {
+			if (b->data().blocked_by.empty()) {
+				queue.push(b);
+			}
+			});
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::afterShift(Vertex* v) {
+		if (rebuilt) {
+			return;
+		}
+		pqt.insert(*v);
+		touch(v);
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::afterRebuild() {
+		// nothing refers to the new elements yet; the search structure is rebuilt by resume()
+		rebuilt = true;
+		touched.clear();
 	}
 
 	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
 	bool VertexRemoval<MG, VRT>::run(std::optional<std::function<bool(int, Number<Kernel>)>> stop) {
+		if (parallel_rounds) {
+			return runRounds(stop);
+		}
+
 		while (true) {
 			Vertex* next = findNextStep();
 			if (next == nullptr) {
@@ -68,28 +210,124 @@ namespace cartocrow::simplification {
 	}
 
 	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
-	MG::Vertex* VertexRemoval<MG, VRT>::findNextStep() {
+	bool VertexRemoval<MG, VRT>::runRounds(std::optional<std::function<bool(int, Number<Kernel>)>> stop) {
+
+		const int round_size = 64 * thread_count;
+
+		std::vector<Vertex*> candidates;
+		std::vector<Vertex*> deferred;
+		std::vector<std::vector<Vertex*>> blockers;
+		std::vector<PredicateStats> counts;
+		std::unordered_set<Vertex*> claimed;
 
 		while (!queue.empty()) {
-			Vertex* v = queue.peek();
 
-			Vertex* u = v->previous();
-			Vertex* w = v->next();
+			// select the cheapest vertices within the slack, such that no two triangles share a vertex:
+			// removing one then cannot change the triangle or the blocking status of another
+			Number<Kernel> limit = queue.peek()->data().cost * (1 + cost_slack);
+			candidates.clear();
+			deferred.clear();
+			claimed.clear();
+			while (!queue.empty() && candidates.size() + deferred.size() < round_size) {
+				Vertex* v = queue.peek();
+				if (!candidates.empty() && v->data().cost > limit) {
+					break;
+				}
+				queue.pop();
 
-			// test whether the operation is blocked
-			Point<Kernel>& up = u->getPoint();
-			Point<Kernel>& vp = v->getPoint();
-			Point<Kernel>& wp = w->getPoint();
-			Triangle<Kernel> T(up, vp, wp);
+				Vertex* u = v->previous();
+				Vertex* w = v->next();
+				if (claimed.contains(u) || claimed.contains(v) || claimed.contains(w)) {
+					deferred.push_back(v);
+				}
+				else {
+					claimed.insert(u);
+					claimed.insert(v);
+					claimed.insert(w);
+					candidates.push_back(v);
+				}
+			}
+
+			// return conflicting vertices before modifying the graph, such that the updates below see them as queued
+			for (Vertex* v : deferred) {
+				queue.push(v);
+			}
 
-			Rectangle<Kernel> rect = utils::boxOf(up, vp, wp);
+			// the blocking tests only read the graph and search structure
+			int n = candidates.size();
+			blockers.resize(n);
+			counts.resize(n);
+			workers.parallelFor(n, [&](int i) {
+				blockers[i].clear();
+				counts[i].reset();
+				findBlockers(candidates[i], counts[i], [&](Vertex* b) {
+					blockers[i].push_back(b);
+					});
+				});
 
-			pqt.findContained(rect, [&T, &u, &v, &w](Vertex& b) {
-				if (&b != u && &b != v && &b != w && !T.has_on_unbounded_side(b.getPoint())) {
-					// blocked, record the pair
-					b.data().blocking.push_back(v);
-					v->data().blocked_by.push_back(&b);
+			// record all blocking relations before removing anything, as a blocker may itself be removed in this round
+			for (int i = 0; i < n; i++) {
+				stats.filtered += counts[i].filtered;
+				stats.exact += counts[i].exact;
+				for (Vertex* b : blockers[i]) {
+					relations.add(b, candidates[i]);
 				}
+			}
+
+			// candidates were taken from the queue in order of cost
+			for (int i = 0; i < n; i++) {
+				// blocked candidates stay out of the queue until released, possibly by a removal in this round
+				Vertex* v = candidates[i];
+				if (!blockers[i].empty()) {
+					continue;
+				}
+
+				if (!stop.has_value() || (*stop)(graph.getEdgeCount(), v->data().cost)) {
+					// return the unblocked candidates that remain
+					for (int j = i; j < n; j++) {
+						if (blockers[j].empty()) {
+							queue.push(candidates[j]);
+						}
+					}
+					return true;
+				}
+
+				removeVertex(v);
+			}
+		}
+
+		return false;
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	template <typename F>
+	void VertexRemoval<MG, VRT>::findBlockers(Vertex* v, PredicateStats& counts, F&& blocked) {
+		Vertex* u = v->previous();
+		Vertex* w = v->next();
+
+		Point<Kernel>& up = u->getPoint();
+		Point<Kernel>& vp = v->getPoint();
+		Point<Kernel>& wp = w->getPoint();
+		detail::FilteredTriangle<Kernel> T(up, vp, wp);
+
+		Rectangle<Kernel> rect = utils::boxOf(up, vp, wp);
+
+		pqt.findContained(rect, [&](Vertex& b) {
+			if (&b != u && &b != v && &b != w && !T.hasOnUnboundedSide(b.getPoint(), counts)) {
+				blocked(&b);
+			}
+			});
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	MG::Vertex* VertexRemoval<MG, VRT>::findNextStep() {
+
+		while (!queue.empty()) {
+			Vertex* v = queue.peek();
+
+			// test whether the operation is blocked, and record the blocking pairs
+			findBlockers(v, stats, [this, v](Vertex* b) {
+				relations.add(b, v);
 				});
 
 			if (v->data().blocked_by.empty()) {
@@ -113,16 +351,19 @@ namespace cartocrow::simplification {
 
 		queue.pop();
 
+		removeVertex(v);
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::removeVertex(Vertex* v) {
+
 		// remove from blocking lists and search structure
 		pqt.remove(*v);
-		for (Vertex* b : v->data().blocking) {
-
-			if (utils::listRemove(v, b->data().blocked_by)) {
-				if (b->data().blocked_by.empty()) {
-					queue.push(b);
-				}
+		relations.clearBlocking(v, [this](Vertex* b) {
+			if (b->data().blocked_by.empty()) {
+				queue.push(b);
 			}
-		}
+			});
 
 		// perform the removal
 		Vertex* u = v->previous();
@@ -132,12 +373,20 @@ namespace cartocrow::simplification {
 			graph.startBatch(v->data().cost);
 		}
 
+		if (sequence != nullptr) {
+			sequence->remove(v);
+		}
+
 		graph.mergeVertex(v);
 
 		if constexpr (ModifiableGraphWithHistory<MG>) {
 			graph.endBatch();
 		}
 
+		if (sequence != nullptr) {
+			sequence->endStep(graph.getEdgeCount());
+		}
+
 		// update the neighbors
 		update(u);
 		update(w);
@@ -166,6 +415,50 @@ namespace cartocrow::simplification {
 		return true;
 	}
 
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::setThreadCount(int threads) {
+		thread_count = std::max(1, threads);
+		workers.resize(thread_count);
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	int VertexRemoval<MG, VRT>::getThreadCount() const {
+		return thread_count;
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::setParallelRounds(bool rounds) {
+		parallel_rounds = rounds;
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	bool VertexRemoval<MG, VRT>::getParallelRounds() const {
+		return parallel_rounds;
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::setCostSlack(double slack) {
+		cost_slack = std::max(0.0, slack);
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	double VertexRemoval<MG, VRT>::getCostSlack() const {
+		return cost_slack;
+	}
+
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::setEliminationSequence(EliminationSequence<Kernel>* seq) {
+		sequence = seq;
+		if (sequence != nullptr) {
+			if constexpr (ModifiableGraphWithHistory<MG>) {
+				sequence->start(graph.getBaseGraph());
+			}
+			else {
+				sequence->start(graph);
+			}
+		}
+	}
+
 	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
 	void VertexRemoval<MG, VRT>::update(Vertex* v) {
 		if (v->degree() != 2) {
@@ -173,22 +466,31 @@ namespace cartocrow::simplification {
 		}
 
 		// clear topology
-		for (Vertex* b : v->data().blocked_by) {
-			utils::listRemove(v, b->data().blocking);
-		}
-		v->data().blocked_by.clear();
+		relations.clearBlockedBy(v);
+
+		enqueue(v, evaluate(v));
+	}
 
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	bool VertexRemoval<MG, VRT>::evaluate(Vertex* v) {
 		Vertex* u = v->previous();
 		Vertex* w = v->next();
 
 		if (u->isNeighborOf(w)) {
-			queue.remove(v);
-			return;
+			return false;
 		}
 
 		v->data().cost = VRT::getCost(v);
+		v->data().cost_approx = CostInterval::of<Kernel>(v->data().cost);
+		return true;
+	}
 
-		if (queue.contains(v)) {
+	template <class MG, class VRT> requires detail::VRSetup<MG, VRT>
+	void VertexRemoval<MG, VRT>::enqueue(Vertex* v, bool removable) {
+		if (!removable) {
+			queue.remove(v);
+		}
+		else if (queue.contains(v)) {
 			queue.update(v);
 		}
 		else {
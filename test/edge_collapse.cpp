@@ -0,0 +1,148 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "library/edge_collapse.h"
+#include "generated_map.h"
+
+using namespace cartocrow;
+using namespace cartocrow::simplification;
+
+TEST_CASE("Blocking by predicates agrees with the intersection constructions") {
+	// small integer coordinates make shared vertices, touching edges and collinear configurations common
+	std::mt19937 rng(3);
+	auto coordinate = [&rng]() {
+		return Number<Exact>(int(rng() % 7));
+	};
+	auto point = [&]() {
+		return Point<Exact>(coordinate(), coordinate());
+	};
+
+	int tested = 0;
+	while (tested < 200000) {
+		Point<Exact> a = point(), b = point(), c = point();
+		Triangle<Exact> T(a, b, c);
+		if (T.orientation() == CGAL::COLLINEAR) {
+			continue;
+		}
+
+		// the segment often starts or ends at a corner of the triangle
+		Point<Exact> corners[3] = { a, b, c };
+		Point<Exact> s = rng() % 2 ? corners[rng() % 3] : point();
+		Point<Exact> t = rng() % 4 == 0 ? corners[rng() % 3] : point();
+		if (s == t) {
+			continue;
+		}
+		bool source_shared = rng() % 2;
+		bool target_shared = rng() % 2;
+		tested++;
+
+		// as EdgeCollapse::blocksByConstruction in exact mode
+		bool expected = false;
+		auto is = CGAL::intersection(T, Segment<Exact>(s, t));
+		if (is.has_value()) {
+			expected = true;
+			if (Point<Exact>* pt = std::get_if<Point<Exact>>(&*is)) {
+				if ((source_shared && *pt == s) || (target_shared && *pt == t)) {
+					expected = false;
+				}
+			}
+		}
+
+		// as EdgeCollapse::blocksByPredicates
+		bool blocks = CGAL::do_intersect(T, Segment<Exact>(s, t))
+			&& !(source_shared && detail::meetsTriangleOnlyAt(T, s, t))
+			&& !(target_shared && detail::meetsTriangleOnlyAt(T, t, s));
+
+		REQUIRE(blocks == expected);
+	}
+}
+
+TEST_CASE("KSBB validates its blocking tests without disagreements") {
+	using InputGraph = StraightGraph<std::monostate, std::monostate, Exact>;
+	using Graph = HistoricEdgeCollapseGraph<Exact>;
+
+	InputGraph* input = test::prepareInput<InputGraph>(4, 12);
+
+	Graph::BaseGraph* base = copy<InputGraph, Graph::BaseGraph>(input);
+	Graph graph(*base);
+	test::Simplifier<Graph> simplifier(graph);
+	simplifier.algorithm().setBlockingValidation(true);
+	simplifier.initialize();
+	simplifier.runTo(100);
+
+	CHECK(graph.getEdgeCount() < input->getEdgeCount());
+	CHECK(simplifier.algorithm().getBlockingDisagreements() == 0);
+	CHECK(test::countCrossings(*base) == 0);
+
+	delete base;
+	delete input;
+}
+
+TEMPLATE_TEST_CASE("KSBB with more threads but without rounds performs the same steps", "", Exact, Inexact) {
+	using InputGraph = StraightGraph<std::monostate, std::monostate, TestType>;
+	using Graph = HistoricEdgeCollapseGraph<TestType>;
+	using Base = Graph::BaseGraph;
+
+	// spiky islands block many collapses at the front of the queue, which more threads test ahead of time
+	InputGraph* input = test::prepareInput<InputGraph>(4, 20, 1, 2);
+
+	// the complexity and cost of every step, and the resulting edges
+	auto simplify = [input](int threads) {
+		Base* base = copy<InputGraph, Base>(input);
+		Graph graph(*base);
+		test::Simplifier<Graph> simplifier(graph);
+		simplifier.algorithm().setThreadCount(threads);
+		simplifier.initialize();
+		std::vector<std::pair<int, double>> steps;
+		simplifier.algorithm().run([&steps](int complexity, Number<TestType> cost) {
+			steps.emplace_back(complexity, CGAL::to_double(cost));
+			return complexity <= 200;
+		});
+		auto edges = test::edgeSet(*base);
+		delete base;
+		return std::make_pair(steps, edges);
+	};
+
+	auto sequential = simplify(1);
+	auto threaded = simplify(4);
+	CHECK(threaded.first == sequential.first);
+	CHECK(threaded.second == sequential.second);
+
+	delete input;
+}
+
+TEST_CASE("KSBB in parallel rounds keeps the map planar and its history recallable") {
+	using InputGraph = StraightGraph<std::monostate, std::monostate, Inexact>;
+	using Graph = HistoricEdgeCollapseGraph<Inexact>;
+
+	InputGraph* input = test::prepareInput<InputGraph>(4, 10);
+
+	for (double slack : { 0.0, 0.5, 4.0 }) {
+		Graph::BaseGraph* base = copy<InputGraph, Graph::BaseGraph>(input);
+		Graph graph(*base);
+		test::Simplifier<Graph> simplifier(graph);
+		simplifier.algorithm().setThreadCount(4);
+		simplifier.algorithm().setParallelRounds(true);
+		simplifier.algorithm().setCostSlack(slack);
+		simplifier.initialize();
+		simplifier.runTo(150);
+		CHECK(base->getEdgeCount() <= 150);
+		CHECK(test::countCrossings(*base) == 0);
+
+		// each round is one batch, which is undone and redone as a whole
+		auto result = test::edgeSet(*base);
+		graph.recallBatches(0);
+		CHECK(test::edgeSet(*base) == test::edgeSet(*input));
+		graph.goToPresent();
+		CHECK(test::edgeSet(*base) == result);
+
+		delete base;
+	}
+
+	delete input;
+}
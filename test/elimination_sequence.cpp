@@ -0,0 +1,144 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <variant>
+
+#include "library/elimination_sequence.h"
+#include "generated_map.h"
+
+using namespace cartocrow;
+using namespace cartocrow::simplification;
+
+namespace {
+
+	using InputGraph = StraightGraph<std::monostate, std::monostate, Inexact>;
+	using Sequence = EliminationSequence<Inexact>;
+
+	std::string serialize(const Sequence& sequence) {
+		std::ostringstream os(std::ios::binary);
+		sequence.write(os);
+		return os.str();
+	}
+
+	bool deserialize(const std::string& data, Sequence& sequence) {
+		std::istringstream is(data, std::ios::binary);
+		return sequence.read(is);
+	}
+
+	// records the sequence of running VW or KSBB on the graph as far as possible
+	template <class Graph> void record(Graph& graph, Sequence& sequence) {
+		test::Simplifier<Graph> simplifier(graph);
+		simplifier.algorithm().setEliminationSequence(&sequence);
+		simplifier.initialize();
+		simplifier.runTo(0);
+		sequence.finish();
+	}
+
+	// the given vector in the output of write(), which starts with the magic, version, sorted flag, input complexity,
+	// and the input points (as doubles, followed by a byte marking them exact), followed by the vectors fixed,
+	// fixed_offsets, fixed_ends, chain_offsets, chain_vertices, chain_by_rank, chain_cyclic and removal_step
+	struct VectorAt {
+		std::size_t offset;
+		std::uint64_t count;
+	};
+
+	VectorAt vectorAt(const std::string& data, int index) {
+		constexpr int sizes[] = { 4, 4, 4, 4, 4, 4, 1, 4 };
+		std::uint64_t n;
+		std::memcpy(&n, data.data() + 17, sizeof(n));
+		std::size_t offset = 25 + n * 2 * (sizeof(double) + 1);
+		for (int i = 0;; i++) {
+			std::uint64_t count;
+			std::memcpy(&count, data.data() + offset, sizeof(count));
+			offset += sizeof(count);
+			if (i == index) {
+				return { offset, count };
+			}
+			offset += (count * sizes[i] + 7) / 8 * 8;
+		}
+	}
+
+	template <typename T> T get(const std::string& data, VectorAt v, int i) {
+		T value;
+		std::memcpy(&value, data.data() + v.offset + i * sizeof(T), sizeof(T));
+		return value;
+	}
+
+	template <typename T> void set(std::string& data, VectorAt v, int i, T value) {
+		std::memcpy(data.data() + v.offset + i * sizeof(T), &value, sizeof(T));
+	}
+
+}
+
+TEMPLATE_TEST_CASE("Extracting from an elimination sequence agrees with recalling history", "",
+                   HistoricVertexRemovalGraph<Inexact>, HistoricEdgeCollapseGraph<Inexact>) {
+	using Base = TestType::BaseGraph;
+
+	InputGraph* input = test::prepareInput<InputGraph>(4, 10);
+	Base* base = copy<InputGraph, Base>(input);
+	TestType graph(*base);
+	Sequence sequence;
+	record(graph, sequence);
+	REQUIRE(sequence.getStepCount() == graph.getBatchCount());
+	REQUIRE(sequence.getMinimumComplexity() < input->getEdgeCount() / 4);
+
+	Sequence read;
+	REQUIRE(deserialize(serialize(sequence), read));
+	CHECK(read.getStepCount() == sequence.getStepCount());
+
+	for (int k = input->getEdgeCount(); k >= sequence.getMinimumComplexity(); k -= 7) {
+		graph.recallComplexity(k);
+		Base extracted;
+		extracted.importLayout(sequence.extractComplexity(k));
+		REQUIRE(test::edgeSet(extracted) == test::edgeSet(*base));
+		Base extracted_read;
+		extracted_read.importLayout(read.extractComplexity(k));
+		REQUIRE(test::edgeSet(extracted_read) == test::edgeSet(*base));
+	}
+
+	delete base;
+	delete input;
+}
+
+TEST_CASE("Reading an elimination sequence rejects chains that extraction cannot rebuild") {
+	using Graph = HistoricVertexRemovalGraph<Inexact>;
+
+	InputGraph* input = test::prepareInput<InputGraph>(4, 10);
+	Graph::BaseGraph* base = copy<InputGraph, Graph::BaseGraph>(input);
+	Graph graph(*base);
+	Sequence sequence;
+	record(graph, sequence);
+	std::string data = serialize(sequence);
+
+	Sequence read;
+	REQUIRE(deserialize(data, read));
+
+	SECTION("a vertex of degree other than 2 is removed") {
+		VectorAt fixed = vectorAt(data, 0);
+		set<std::int32_t>(data, vectorAt(data, 7), get<std::int32_t>(data, fixed, 0), 1);
+	}
+	SECTION("a cyclic chain loses all its vertices") {
+		VectorAt offsets = vectorAt(data, 3);
+		VectorAt vertices = vectorAt(data, 4);
+		VectorAt cyclic = vectorAt(data, 6);
+		int c = 0;
+		while (get<std::uint8_t>(data, cyclic, c) == 0) {
+			c++;
+		}
+		for (int i = get<std::int32_t>(data, offsets, c); i < get<std::int32_t>(data, offsets, c + 1); i++) {
+			set<std::int32_t>(data, vectorAt(data, 7), get<std::int32_t>(data, vertices, i), 1);
+		}
+	}
+	SECTION("a removal step lies beyond the last step") {
+		set<std::int32_t>(data, vectorAt(data, 7), get<std::int32_t>(data, vectorAt(data, 4), 1),
+		                  sequence.getStepCount() + 1);
+	}
+	CHECK(!deserialize(data, read));
+
+	delete base;
+	delete input;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include <cartocrow/core/core.h>
+
+#include "library/edge_collapse.h"
+#include "library/vertex_removal.h"
+
+namespace cartocrow::simplification::test {
+
+	/// <summary>
+	/// Builds a planar map of n by n cells, whose borders are jittered chains of k interior vertices. Each cell holds
+	/// islands by islands small islands and an isolated vertex. A single island is nearly round; several islands are
+	/// spiky, such that simplifying them runs into blocking vertices. Borders deviate at most 9 / (k + 1) from the grid
+	/// lines, so many islands per cell need long chains to stay clear of them. Edge directions are random, so the graph
+	/// still needs to be oriented.
+	/// </summary>
+	template <class Graph> Graph* generateMap(int n, int k, unsigned seed = 1, int islands = 1) {
+		using Vertex = Graph::Vertex;
+		using Kernel = Graph::Kernel;
+
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+
+		Graph* graph = new Graph();
+		auto point = [](double x, double y) {
+			return Point<Kernel>(x, y);
+		};
+
+		std::vector<std::vector<Vertex*>> corners(n + 1, std::vector<Vertex*>(n + 1));
+		for (int i = 0; i <= n; i++) {
+			for (int j = 0; j <= n; j++) {
+				corners[i][j] = graph->addVertex(point(i * 10.0, j * 10.0));
+			}
+		}
+
+		auto chain = [&](Vertex* a, Vertex* b, bool horizontal) {
+			double ax = CGAL::to_double(a->getPoint().x()), ay = CGAL::to_double(a->getPoint().y());
+			double bx = CGAL::to_double(b->getPoint().x()), by = CGAL::to_double(b->getPoint().y());
+			Vertex* prev = a;
+			for (int t = 1; t <= k; t++) {
+				double f = t / (double) (k + 1);
+				double x = ax + f * (bx - ax);
+				double y = ay + f * (by - ay);
+				double offset = jitter(rng) * 30.0 / (k + 1);
+				Vertex* v = graph->addVertex(horizontal ? point(x, y + offset) : point(x + offset, y));
+				graph->addEdge(prev, v);
+				prev = v;
+			}
+			if (rng() % 2) {
+				graph->addEdge(prev, b);
+			}
+			else {
+				graph->addEdge(b, prev);
+			}
+		};
+
+		for (int i = 0; i <= n; i++) {
+			for (int j = 0; j <= n; j++) {
+				if (i < n) {
+					chain(corners[i][j], corners[i + 1][j], true);
+				}
+				if (j < n) {
+					chain(corners[i][j], corners[i][j + 1], false);
+				}
+			}
+		}
+
+		// islands around the centers of a sub-grid of the cell, within 0.4 times its spacing
+		double spacing = 10.0 / islands;
+		for (int i = 0; i < n; i++) {
+			for (int j = 0; j < n; j++) {
+				for (int a = 0; a < islands; a++) {
+					for (int b = 0; b < islands; b++) {
+						double cx = i * 10 + (a + 0.5) * spacing, cy = j * 10 + (b + 0.5) * spacing;
+						int m = 8 + k;
+						Vertex* first = nullptr;
+						Vertex* prev = nullptr;
+						for (int t = 0; t < m; t++) {
+							double angle = 2 * std::numbers::pi * t / m;
+							double r = islands == 1 ? 2 + jitter(rng) : spacing * (0.25 + jitter(rng) / 2);
+							Vertex* v = graph->addVertex(point(cx + r * std::cos(angle), cy + r * std::sin(angle)));
+							if (prev == nullptr) {
+								first = v;
+							}
+							else if (rng() % 2) {
+								graph->addEdge(prev, v);
+							}
+							else {
+								graph->addEdge(v, prev);
+							}
+							prev = v;
+						}
+						graph->addEdge(prev, first);
+					}
+				}
+				// off the islands, where four of them meet if there are several
+				double offset = islands == 1 ? 8.5 : spacing;
+				graph->addVertex(point(i * 10 + offset, j * 10 + offset));
+			}
+		}
+
+		return graph;
+	}
+
+	/// <summary>
+	/// Generates a map with generateMap, and orients it and sorts its incident edges as the loaders do.
+	/// </summary>
+	template <class Graph> Graph* prepareInput(int n, int k, unsigned seed = 1, int islands = 1) {
+		Graph* graph = generateMap<Graph>(n, k, seed, islands);
+		graph->orient();
+		graph->sortIncidentEdges();
+		return graph;
+	}
+
+	/// <summary>
+	/// The edges of the graph by their coordinates, independent of the order of vertices and edges.
+	/// </summary>
+	template <class Graph> std::vector<std::array<double, 4>> edgeSet(Graph& graph) {
+		std::vector<std::array<double, 4>> result;
+		for (auto* e : graph.getEdges()) {
+			const auto& s = e->getSource()->getPoint();
+			const auto& t = e->getTarget()->getPoint();
+			result.push_back({ CGAL::to_double(s.x()), CGAL::to_double(s.y()), CGAL::to_double(t.x()),
+			                   CGAL::to_double(t.y()) });
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	// selected by specialization, as each algorithm only accepts graphs with its own data
+	template <class Graph, bool collapses> struct AlgorithmOf {
+		using type = VisvalingamWhyatt<Graph>;
+	};
+	template <class Graph> struct AlgorithmOf<Graph, true> {
+		using type = KronenfeldEtAl<Graph>;
+	};
+
+	/// <summary>
+	/// VW on a vertex removal graph, or KSBB on an edge collapse graph, with quadtrees covering maps of up to 4 by 4
+	/// cells. The algorithm can be configured through algorithm() before initializing it.
+	/// </summary>
+	template <class Graph> class Simplifier {
+	public:
+		using Kernel = Graph::Kernel;
+		static constexpr bool collapses = std::is_same_v<Graph, HistoricEdgeCollapseGraph<Kernel>>;
+		using Algorithm = AlgorithmOf<Graph, collapses>::type;
+
+	private:
+		Rectangle<Kernel> box;
+		VertexQuadTree<Graph> pqt;
+		EdgeQuadTree<Graph> sqt;
+		Algorithm alg;
+
+		Algorithm create(Graph& graph) {
+			if constexpr (collapses) {
+				return Algorithm(graph, sqt, pqt);
+			}
+			else {
+				return Algorithm(graph, pqt);
+			}
+		}
+
+	public:
+		Simplifier(Graph& graph) : box(-10, -10, 50, 50), pqt(box, 6), sqt(box, 6, 0.05), alg(create(graph)) {}
+
+		Algorithm& algorithm() {
+			return alg;
+		}
+
+		void initialize() {
+			if constexpr (collapses) {
+				alg.initialize(true, true);
+			}
+			else {
+				alg.initialize(true);
+			}
+		}
+
+		void runTo(int complexity) {
+			alg.run([complexity](int c, Number<Kernel>) { return c <= complexity; });
+		}
+	};
+
+	/// <summary>
+	/// Initializes VW or KSBB on the graph, and runs it to the complexity.
+	/// </summary>
+	template <class Graph> void simplify(Graph& graph, int complexity) {
+		Simplifier<Graph> simplifier(graph);
+		simplifier.initialize();
+		simplifier.runTo(complexity);
+	}
+
+	/// <summary>
+	/// Counts the pairs of edges without common endpoints that intersect.
+	/// </summary>
+	template <class Graph> int countCrossings(Graph& graph) {
+		auto& edges = graph.getEdges();
+		int crossings = 0;
+		for (int i = 0; i < edges.size(); i++) {
+			for (int j = i + 1; j < edges.size(); j++) {
+				auto* a = edges[i]->getSource();
+				auto* b = edges[i]->getTarget();
+				auto* c = edges[j]->getSource();
+				auto* d = edges[j]->getTarget();
+				if (a != c && a != d && b != c && b != d && CGAL::do_intersect(edges[i]->getSegment(), edges[j]->getSegment())) {
+					crossings++;
+				}
+			}
+		}
+		return crossings;
+	}
+
+} // namespace cartocrow::simplification::test
@@ -0,0 +1,147 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "library/graph_snapshot.h"
+#include "library/straight_graph.h"
+#include "generated_map.h"
+
+using namespace cartocrow;
+using namespace cartocrow::simplification;
+
+namespace {
+
+	using Graph = StraightGraph<std::monostate, std::monostate, Exact>;
+
+	GraphLayout<Exact> generateLayout() {
+		Graph* graph = test::prepareInput<Graph>(3, 5);
+		GraphLayout<Exact> layout = graph->exportLayout();
+		delete graph;
+		return layout;
+	}
+
+	std::string serialize(const GraphLayout<Exact>& layout) {
+		std::ostringstream os(std::ios::binary);
+		writeSnapshot(os, layout);
+		return os.str();
+	}
+
+	bool deserialize(const std::string& data, GraphLayout<Exact>& layout) {
+		std::istringstream is(data, std::ios::binary);
+		return readSnapshot(is, layout);
+	}
+
+	bool sameLayout(const GraphLayout<Exact>& a, const GraphLayout<Exact>& b) {
+		if (a.points != b.points || a.edges != b.edges || a.incident_offsets != b.incident_offsets
+			|| a.incident != b.incident || a.oriented != b.oriented || a.sorted != b.sorted
+			|| a.boundaries.size() != b.boundaries.size()) {
+			return false;
+		}
+		for (int i = 0; i < a.boundaries.size(); i++) {
+			auto& ba = a.boundaries[i];
+			auto& bb = b.boundaries[i];
+			if (ba.first != bb.first || ba.last != bb.last || ba.cyclic != bb.cyclic) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// index of a degree-2 vertex in the layout
+	int degreeTwoVertex(const GraphLayout<Exact>& layout) {
+		for (int v = 0; v < layout.points.size(); v++) {
+			if (layout.incident_offsets[v + 1] - layout.incident_offsets[v] == 2) {
+				return v;
+			}
+		}
+		return -1;
+	}
+
+} // namespace
+
+TEST_CASE("Snapshots round-trip through write and read") {
+	GraphLayout<Exact> layout = generateLayout();
+	// a coordinate that is not a double under exact kernels is stored in the exact section
+	layout.points[0] = Point<Exact>(Number<Exact>(1) / 3, layout.points[0].y());
+
+	GraphLayout<Exact> read;
+	REQUIRE(deserialize(serialize(layout), read));
+	CHECK(sameLayout(layout, read));
+
+	Graph graph;
+	graph.importLayout(read);
+	CHECK(graph.getVertexCount() == layout.points.size());
+	CHECK(graph.getEdgeCount() == layout.edges.size());
+	CHECK(sameLayout(graph.exportLayout(), layout));
+}
+
+TEST_CASE("Truncated snapshots are rejected") {
+	std::string data = serialize(generateLayout());
+	GraphLayout<Exact> read;
+	for (int length = 0; length < data.size(); length += 1 + length / 8) {
+		CHECK(!deserialize(data.substr(0, length), read));
+	}
+}
+
+TEST_CASE("Structurally corrupt snapshots are rejected") {
+	GraphLayout<Exact> layout = generateLayout();
+	GraphLayout<Exact> read;
+	int v = degreeTwoVertex(layout);
+	REQUIRE(v >= 0);
+	int first = layout.incident_offsets[v];
+
+	SECTION("incident edge without the vertex as endpoint") {
+		for (int e = 0; e < layout.edges.size(); e++) {
+			if (layout.edges[e].first != v && layout.edges[e].second != v) {
+				layout.incident[first] = e;
+				break;
+			}
+		}
+		CHECK(!deserialize(serialize(layout), read));
+	}
+
+	SECTION("incident edge listed twice") {
+		layout.incident[first + 1] = layout.incident[first];
+		CHECK(!deserialize(serialize(layout), read));
+	}
+
+	SECTION("degree-2 vertex with its out-edge first") {
+		std::swap(layout.incident[first], layout.incident[first + 1]);
+		CHECK(!deserialize(serialize(layout), read));
+	}
+
+	SECTION("boundary that does not reach its last edge") {
+		REQUIRE(layout.boundaries.size() >= 2);
+		layout.boundaries[0].last = layout.boundaries[1].first;
+		CHECK(!deserialize(serialize(layout), read));
+	}
+
+	SECTION("boundaries that share edges") {
+		layout.boundaries[1] = layout.boundaries[0];
+		CHECK(!deserialize(serialize(layout), read));
+	}
+}
+
+TEST_CASE("Exact coordinate records must name an axis") {
+	std::string data = serialize(generateLayout());
+
+	// append one exact record for the first vertex, overriding its coordinate on the given axis
+	auto withRecord = [&data](std::int32_t axis) {
+		std::string result = data;
+		std::uint64_t exact_count = 1;
+		std::memcpy(result.data() + offsetof(SnapshotHeader, exact_count), &exact_count, sizeof(exact_count));
+		std::int32_t record[4] = { 0, axis, 1, 0 };
+		result.append(reinterpret_cast<const char*>(record), sizeof(record));
+		result.append("7");
+		result.append(7, '\0');
+		return result;
+	};
+
+	GraphLayout<Exact> read;
+	REQUIRE(deserialize(withRecord(1), read));
+	CHECK(read.points[0].y() == 7);
+	CHECK(!deserialize(withRecord(2), read));
+	CHECK(!deserialize(withRecord(-1), read));
+}
@@ -0,0 +1,256 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "library/edge_collapse.h"
+#include "library/graph_snapshot.h"
+#include "library/vertex_removal.h"
+#include "generated_map.h"
+
+using namespace cartocrow;
+using namespace cartocrow::simplification;
+
+namespace {
+
+	using InputGraph = StraightGraph<std::monostate, std::monostate, Inexact>;
+	using Graph = HistoricVertexRemovalGraph<Inexact>;
+
+	InputGraph* generateInput() {
+		return test::prepareInput<InputGraph>(4, 10);
+	}
+
+	std::string serialize(Graph& graph) {
+		std::ostringstream os(std::ios::binary);
+		graph.write(os);
+		return os.str();
+	}
+
+	bool deserialize(const std::string& data, Graph& graph) {
+		std::istringstream is(data, std::ios::binary);
+		return graph.read(is);
+	}
+
+	// position of the first logged operation in the output of write(), which starts with the magic, version, input
+	// complexity, boundary count and fingerprint, applied batch count and maximum cost, followed by the snapshot, edge
+	// identifiers and identifier count
+	std::size_t operationsOffset(Graph& graph) {
+		std::ostringstream os(std::ios::binary);
+		writeSnapshot(os, graph.getBaseGraph().exportLayout());
+		std::size_t header = 8 + 4 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(double) + 1;
+		std::size_t ids = sizeof(std::uint64_t) + graph.getEdgeCount() * sizeof(std::int32_t);
+		return header + os.str().size() + ids + 2 * sizeof(std::uint64_t);
+	}
+
+	void setOperationEdge(std::string& data, std::size_t offset, int op, int k, std::int32_t id) {
+		std::size_t at = offset + op * sizeof(detail::LoggedOperation) + offsetof(detail::LoggedOperation, edges)
+			+ k * sizeof(int);
+		std::memcpy(data.data() + at, &id, sizeof(id));
+	}
+
+	std::int32_t getOperationEdge(const std::string& data, std::size_t offset, int op, int k) {
+		std::int32_t id;
+		std::size_t at = offset + op * sizeof(detail::LoggedOperation) + offsetof(detail::LoggedOperation, edges)
+			+ k * sizeof(int);
+		std::memcpy(&id, data.data() + at, sizeof(id));
+		return id;
+	}
+
+}
+
+TEST_CASE("History survives a write and read round trip") {
+	InputGraph* input = generateInput();
+	Graph::BaseGraph* base = copy<InputGraph, Graph::BaseGraph>(input);
+	Graph graph(*base);
+	test::simplify(graph, 60);
+	REQUIRE(graph.getBatchCount() > 0);
+	graph.recallBatches(graph.getBatchCount() / 2);
+
+	Graph::BaseGraph* read_base = copy<InputGraph, Graph::BaseGraph>(input);
+	Graph read(*read_base);
+	REQUIRE(deserialize(serialize(graph), read));
+	CHECK(read.getBatchCount() == graph.getBatchCount());
+	CHECK(read.getAppliedBatchCount() == graph.getAppliedBatchCount());
+	CHECK(read.getInputComplexity() == graph.getInputComplexity());
+	CHECK(test::edgeSet(*read_base) == test::edgeSet(*base));
+
+	std::mt19937 rng(7);
+	for (int i = 0; i < 50; i++) {
+		int count = rng() % (graph.getBatchCount() + 1);
+		graph.recallBatches(count);
+		read.recallBatches(count);
+		REQUIRE(test::edgeSet(*read_base) == test::edgeSet(*base));
+	}
+
+	delete read_base;
+	delete base;
+	delete input;
+}
+
+TEST_CASE("Reading history rejects operations on edges that are not in the graph") {
+	InputGraph* input = generateInput();
+	Graph::BaseGraph* base = copy<InputGraph, Graph::BaseGraph>(input);
+	Graph graph(*base);
+	test::simplify(graph, 60);
+	std::string data = serialize(graph);
+	std::size_t offset = operationsOffset(graph);
+
+	Graph::BaseGraph* read_base = copy<InputGraph, Graph::BaseGraph>(input);
+	Graph read(*read_base);
+	REQUIRE(deserialize(data, read));
+
+	SECTION("an operation consumes the edge it produces") {
+		setOperationEdge(data, offset, 0, 0, getOperationEdge(data, offset, 0, 2));
+	}
+	SECTION("an operation consumes an edge erased by an earlier operation") {
+		// vertex removal logs one operation per removed edge
+		int last = graph.getInputComplexity() - graph.getEdgeCount() - 1;
+		REQUIRE(last > 0);
+		setOperationEdge(data, offset, last, 0, getOperationEdge(data, offset, 0, 0));
+	}
+	SECTION("an operation produces an edge that is still in the graph") {
+		setOperationEdge(data, offset, 0, 2, getOperationEdge(data, offset, 0, 1));
+	}
+	CHECK(!deserialize(data, read));
+
+	delete read_base;
+	delete base;
+	delete input;
+}
+
+TEST_CASE("Reading history rejects histories recorded on another input") {
+	InputGraph* input = generateInput();
+	Graph::BaseGraph* base = copy<InputGraph, Graph::BaseGraph>(input);
+	Graph graph(*base);
+	test::simplify(graph, 60);
+	std::string data = serialize(graph);
+
+	InputGraph* other = nullptr;
+	SECTION("a map with the same number of edges and boundaries") {
+		other = test::prepareInput<InputGraph>(4, 10, 2);
+	}
+	SECTION("the same map with one vertex moved") {
+		other = generateInput();
+		InputGraph::Vertex* v = other->getVertices().back();
+		other->shiftVertex(v, Point<Inexact>(v->getPoint().x() + 0.01, v->getPoint().y()));
+	}
+	REQUIRE(other->getEdgeCount() == input->getEdgeCount());
+	REQUIRE(other->getBoundaryCount() == input->getBoundaryCount());
+
+	Graph::BaseGraph* other_base = copy<InputGraph, Graph::BaseGraph>(other);
+	Graph read(*other_base);
+	test::simplify(read, 100);
+	std::vector<std::array<double, 4>> before = test::edgeSet(*other_base);
+	int batches = read.getBatchCount();
+
+	CHECK(!deserialize(data, read));
+	CHECK(read.getBatchCount() == batches);
+	CHECK(test::edgeSet(*other_base) == before);
+
+	delete other_base;
+	delete other;
+	delete base;
+	delete input;
+}
+
+TEMPLATE_TEST_CASE("Recalling from checkpoints agrees with replaying the history", "", HistoricVertexRemovalGraph<Inexact>,
+                   HistoricEdgeCollapseGraph<Inexact>) {
+	using Base = TestType::BaseGraph;
+
+	InputGraph* input = generateInput();
+	Base* replay_base = copy<InputGraph, Base>(input);
+	Base* checkpoint_base = copy<InputGraph, Base>(input);
+	TestType replay(*replay_base);
+	TestType checkpointed(*checkpoint_base);
+	checkpointed.setCheckpointInterval(9);
+
+	test::simplify(replay, 150);
+	test::simplify(checkpointed, 150);
+	REQUIRE(checkpointed.getCheckpointCount() > 1);
+
+	std::mt19937 rng(5);
+	for (int i = 0; i < 100; i++) {
+		int count = rng() % (replay.getBatchCount() + 1);
+		replay.recallBatches(count);
+		checkpointed.recallBatches(count);
+		REQUIRE(test::edgeSet(*checkpoint_base) == test::edgeSet(*replay_base));
+	}
+
+	// continuing from the present takes further checkpoints
+	replay.goToPresent();
+	checkpointed.goToPresent();
+	test::simplify(replay, 60);
+	test::simplify(checkpointed, 60);
+	REQUIRE(checkpointed.getBatchCount() == replay.getBatchCount());
+
+	// reading retakes the checkpoints
+	Base* read_base = copy<InputGraph, Base>(input);
+	TestType read(*read_base);
+	read.setCheckpointInterval(9);
+	std::ostringstream os(std::ios::binary);
+	replay.write(os);
+	std::istringstream is(os.str(), std::ios::binary);
+	REQUIRE(read.read(is));
+	CHECK(read.getCheckpointCount() == checkpointed.getCheckpointCount());
+
+	for (int i = 0; i < 100; i++) {
+		int count = rng() % (replay.getBatchCount() + 1);
+		replay.recallBatches(count);
+		checkpointed.recallBatches(count);
+		read.recallBatches(count);
+		REQUIRE(test::edgeSet(*checkpoint_base) == test::edgeSet(*replay_base));
+		REQUIRE(test::edgeSet(*read_base) == test::edgeSet(*replay_base));
+	}
+
+	delete read_base;
+	delete checkpoint_base;
+	delete replay_base;
+	delete input;
+}
+
+TEMPLATE_TEST_CASE("Resuming after recalling history continues as if initialized", "", HistoricVertexRemovalGraph<Inexact>,
+                   HistoricEdgeCollapseGraph<Inexact>) {
+	using Base = TestType::BaseGraph;
+
+	InputGraph* input = generateInput();
+
+	// recalling a few batches keeps following the changes, recalling all of them falls back to initializing
+	for (bool all : { false, true }) {
+		Base* resumed_base = copy<InputGraph, Base>(input);
+		Base* initialized_base = copy<InputGraph, Base>(input);
+		TestType resumed(*resumed_base);
+		TestType initialized(*initialized_base);
+		test::Simplifier<TestType> resumed_alg(resumed);
+		test::Simplifier<TestType> initialized_alg(initialized);
+
+		resumed_alg.initialize();
+		initialized_alg.initialize();
+		resumed_alg.runTo(150);
+		initialized_alg.runTo(150);
+
+		int count = all ? 0 : resumed.getBatchCount() - 5;
+		REQUIRE(count >= 0);
+		resumed.recallBatches(count);
+		initialized.recallBatches(count);
+		resumed.goToPresent();
+		initialized.goToPresent();
+
+		resumed_alg.algorithm().resume();
+		initialized_alg.initialize();
+		resumed_alg.runTo(60);
+		initialized_alg.runTo(60);
+		CHECK(test::edgeSet(*resumed_base) == test::edgeSet(*initialized_base));
+
+		delete initialized_base;
+		delete resumed_base;
+	}
+
+	delete input;
+}
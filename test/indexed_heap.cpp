@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "library/indexed_heap.h"
+
+using namespace cartocrow::simplification::detail;
+
+namespace {
+
+	struct Item {
+		int key;
+		int qid = -1;
+	};
+
+	struct ItemTraits {
+		using Element = Item;
+
+		static void setIndex(Item* item, int index) {
+			item->qid = index;
+		}
+
+		static int getIndex(Item* item) {
+			return item->qid;
+		}
+
+		static int compare(Item* a, Item* b) {
+			return a->key < b->key ? -1 : a->key > b->key ? 1 : 0;
+		}
+	};
+
+	// checks the heap against the multiset of keys of the queued items
+	void checkAgainst(IndexedHeap<ItemTraits>& heap, std::multiset<int>& keys, std::vector<Item>& items) {
+		REQUIRE(heap.size() == keys.size());
+		REQUIRE(heap.empty() == keys.empty());
+		if (!keys.empty()) {
+			REQUIRE(heap.peek()->key == *keys.begin());
+		}
+
+		int queued = 0;
+		for (Item& item : items) {
+			queued += heap.contains(&item);
+		}
+		REQUIRE(queued == keys.size());
+	}
+
+} // namespace
+
+TEST_CASE("IndexedHeap matches a multiset under random operations") {
+	for (unsigned seed = 1; seed <= 20; seed++) {
+		std::mt19937 rng(seed);
+		// few distinct keys, such that ties are common
+		std::uniform_int_distribution<int> key(0, 50);
+
+		std::vector<Item> items(200);
+		std::multiset<int> keys;
+		IndexedHeap<ItemTraits> heap;
+
+		for (int step = 0; step < 5000; step++) {
+			Item& item = items[rng() % items.size()];
+			bool queued = heap.contains(&item);
+
+			switch (rng() % 5) {
+			case 0:
+				// push
+				if (!queued) {
+					item.key = key(rng);
+					heap.push(&item);
+					keys.insert(item.key);
+				}
+				break;
+			case 1:
+				// remove, also of items that are not queued
+				if (queued) {
+					keys.erase(keys.find(item.key));
+				}
+				heap.remove(&item);
+				REQUIRE(!heap.contains(&item));
+				break;
+			case 2:
+				// update the key of a queued item
+				if (queued) {
+					keys.erase(keys.find(item.key));
+					item.key = key(rng);
+					keys.insert(item.key);
+					heap.update(&item);
+				}
+				break;
+			case 3:
+				// pop
+				if (!heap.empty()) {
+					Item* top = heap.pop();
+					REQUIRE(top->key == *keys.begin());
+					keys.erase(keys.begin());
+					REQUIRE(!heap.contains(top));
+				}
+				break;
+			case 4: {
+				// peek at the smallest elements without modifying the heap
+				int count = rng() % 20;
+				std::vector<Item*> smallest;
+				heap.peekSmallest(count, smallest);
+				REQUIRE(smallest.size() == std::min<size_t>(count, keys.size()));
+				auto it = keys.begin();
+				for (Item* s : smallest) {
+					REQUIRE(heap.contains(s));
+					REQUIRE(s->key == *it);
+					++it;
+				}
+				std::sort(smallest.begin(), smallest.end());
+				REQUIRE(std::adjacent_find(smallest.begin(), smallest.end()) == smallest.end());
+				break;
+			}
+			}
+
+			checkAgainst(heap, keys, items);
+		}
+	}
+}
+
+TEST_CASE("IndexedHeap builds from a vector of elements") {
+	std::mt19937 rng(7);
+	std::vector<Item> items(500);
+	std::vector<Item*> elements;
+	std::multiset<int> keys;
+	for (Item& item : items) {
+		item.key = rng() % 100;
+		if (rng() % 4 != 0) {
+			elements.push_back(&item);
+			keys.insert(item.key);
+		}
+	}
+
+	IndexedHeap<ItemTraits> heap;
+	heap.push(&items[0]);
+	heap.build(std::move(elements));
+	checkAgainst(heap, keys, items);
+
+	while (!heap.empty()) {
+		REQUIRE(heap.pop()->key == *keys.begin());
+		keys.erase(keys.begin());
+	}
+
+	// clear does not access the elements
+	heap.push(&items[1]);
+	heap.clear();
+	REQUIRE(heap.empty());
+	REQUIRE(!heap.contains(&items[1]));
+}
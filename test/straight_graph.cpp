@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <random>
+#include <variant>
+#include <vector>
+
+#include "library/straight_graph.h"
+#include "generated_map.h"
+
+using namespace cartocrow;
+using namespace cartocrow::simplification;
+
+TEST_CASE("Sorting incident edges agrees with comparing directions") {
+	using Graph = StraightGraph<std::monostate, std::monostate, Exact>;
+	using Dir = Direction<Exact>;
+
+	// integer coordinates below 2^53 keep all edge vectors representable, so only the pseudo-angles round
+	constexpr long long big = 1LL << 26;
+	std::mt19937_64 rng(11);
+	auto coordinate = [&rng](long long range) {
+		return (long long)(rng() % (2 * range + 1)) - range;
+	};
+
+	for (int round = 0; round < 200; round++) {
+		Graph graph;
+		long long cx = coordinate(big);
+		long long cy = coordinate(big);
+		Graph::Vertex* center = graph.addVertex(Point<Exact>((double) cx, (double) cy));
+
+		// spokes on and barely off the axes, and pairs of spokes whose pseudo-angles are closer than their rounding
+		std::vector<std::pair<long long, long long>> offsets = { { big, 0 }, { 0, big }, { -big, 0 }, { 0, -big },
+			{ big, 1 }, { big, -1 }, { -1, big }, { 1, -big }, { -big, 1 }, { -big, -1 }, { 1, big }, { -1, -big } };
+		for (int i = 0; i < 8; i++) {
+			long long dx = coordinate(big);
+			long long dy = coordinate(big);
+			if (dx == 0 || dy == 0) {
+				continue;
+			}
+			offsets.push_back({ 4 * dx, 4 * dy });
+			offsets.push_back({ 4 * dx + 1, 4 * dy });
+		}
+		std::shuffle(offsets.begin(), offsets.end(), rng);
+
+		std::vector<Graph::Edge*> expected;
+		for (auto [dx, dy] : offsets) {
+			Graph::Vertex* w = graph.addVertex(Point<Exact>((double) (cx + dx), (double) (cy + dy)));
+			expected.push_back(graph.addEdge(center, w));
+		}
+		auto direction = [&center](Graph::Edge* e) {
+			return Dir(e->other(center)->getPoint() - center->getPoint());
+		};
+		std::sort(expected.begin(), expected.end(), [&direction](Graph::Edge* a, Graph::Edge* b) {
+			return direction(a) < direction(b);
+		});
+
+		graph.sortIncidentEdges();
+		for (int i = 0; i < expected.size(); i++) {
+			REQUIRE(center->edge(i) == expected[i]);
+		}
+	}
+}
+
+TEST_CASE("Building a graph skips self-loops and repeated edges") {
+	using Graph = StraightGraph<std::monostate, std::monostate, Inexact>;
+
+	// a square with a diagonal, given with a self-loop and with the diagonal and a side repeated in either direction
+	std::vector<Point<Inexact>> points = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+	std::vector<std::pair<int, int>> pairs = { { 0, 1 }, { 1, 2 }, { 2, 2 }, { 2, 3 }, { 0, 2 }, { 3, 0 }, { 2, 0 },
+		{ 1, 0 }, { 0, 2 } };
+
+	Graph graph;
+	graph.build(points, pairs);
+	REQUIRE(graph.getVertexCount() == 4);
+	REQUIRE(graph.getEdgeCount() == 5);
+	CHECK(graph.isOriented());
+	CHECK(graph.isSorted());
+
+	// each distinct edge remains once
+	std::vector<std::pair<int, int>> expected = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 0, 2 }, { 3, 0 } };
+	for (auto [s, t] : expected) {
+		Graph::Vertex* source = graph.getVertices()[s];
+		Graph::Vertex* target = graph.getVertices()[t];
+		CHECK(source->isNeighborOf(target));
+	}
+
+	// adding to a graph with edges still skips the edges it has
+	graph.addEdges({ { 1, 0 }, { 1, 3 }, { 3, 1 } });
+	CHECK(graph.getEdgeCount() == 6);
+}
+
+TEST_CASE("Transferring a graph to other data types keeps its layout") {
+	using InputGraph = StraightGraph<std::monostate, std::monostate, Exact>;
+	using OutputGraph = StraightGraph<int, int, Exact>;
+
+	InputGraph* input = test::prepareInput<InputGraph>(3, 5);
+	GraphLayout<Exact> expected = input->exportLayout();
+
+	OutputGraph* output = transfer<InputGraph, OutputGraph>(input);
+	CHECK(input == nullptr);
+	CHECK(output->isOriented());
+	CHECK(output->isSorted());
+
+	GraphLayout<Exact> layout = output->exportLayout();
+	CHECK(layout.points == expected.points);
+	CHECK(layout.edges == expected.edges);
+	CHECK(layout.incident_offsets == expected.incident_offsets);
+	CHECK(layout.incident == expected.incident);
+	REQUIRE(layout.boundaries.size() == expected.boundaries.size());
+	for (int i = 0; i < layout.boundaries.size(); i++) {
+		CHECK(layout.boundaries[i].first == expected.boundaries[i].first);
+		CHECK(layout.boundaries[i].last == expected.boundaries[i].last);
+		CHECK(layout.boundaries[i].cyclic == expected.boundaries[i].cyclic);
+	}
+
+	delete output;
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <variant>
+
+#include "library/vertex_removal.h"
+#include "generated_map.h"
+
+using namespace cartocrow;
+using namespace cartocrow::simplification;
+
+namespace {
+
+	using InputGraph = StraightGraph<std::monostate, std::monostate, Inexact>;
+	using Graph = HistoricVertexRemovalGraph<Inexact>;
+
+	// runs VW to the complexity, returning the simplified graph
+	Graph::BaseGraph* simplify(InputGraph* input, int threads, bool rounds, double slack, int complexity) {
+		Graph::BaseGraph* base = copy<InputGraph, Graph::BaseGraph>(input);
+		Graph graph(*base);
+		test::Simplifier<Graph> simplifier(graph);
+		simplifier.algorithm().setThreadCount(threads);
+		simplifier.algorithm().setParallelRounds(rounds);
+		simplifier.algorithm().setCostSlack(slack);
+		simplifier.initialize();
+		simplifier.runTo(complexity);
+		return base;
+	}
+
+}
+
+TEST_CASE("VW with more threads but without rounds performs the same steps") {
+	InputGraph* input = test::prepareInput<InputGraph>(4, 10);
+
+	Graph::BaseGraph* sequential = simplify(input, 1, false, 0, 80);
+	Graph::BaseGraph* threaded = simplify(input, 4, false, 0, 80);
+	CHECK(test::edgeSet(*threaded) == test::edgeSet(*sequential));
+
+	delete threaded;
+	delete sequential;
+	delete input;
+}
+
+TEST_CASE("VW in parallel rounds keeps the map planar") {
+	InputGraph* input = test::prepareInput<InputGraph>(4, 10);
+
+	for (double slack : { 0.0, 0.5, 4.0 }) {
+		Graph::BaseGraph* base = simplify(input, 4, true, slack, 150);
+		CHECK(base->getEdgeCount() <= 150);
+		CHECK(test::countCrossings(*base) == 0);
+		delete base;
+	}
+
+	delete input;
+}